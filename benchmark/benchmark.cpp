@@ -0,0 +1,254 @@
+/**
+ * @file benchmark.cpp
+ * @brief Times each stage of the converter on synthetic statements, and optionally the whole program on real PDF statements.
+ *
+ * Usage: benchmark [--lines <N>] [--iterations <N>] [--seed <N>] [--text <file>] [--pdfs <directory>]
+ *
+ * Everything is written into a scratch directory in the system's temp directory, so ./output is left alone.
+ */
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "statement_generator.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/line_classifier.h"
+#include "wells_fargo_statement_converter/log_level.h"
+#include "wells_fargo_statement_converter/pdf_processor.h"
+#include "wells_fargo_statement_converter/transaction_store.h"
+
+LOG_SETUP
+
+namespace {
+
+struct BenchmarkOptions {
+    size_t lineCount = 200000; /**< --lines <N>. The number of synthetic transaction section lines */
+    unsigned int iterations = 5; /**< --iterations <N>. How many times each stage is run. The best and the mean time are reported */
+    uint32_t seed = 1; /**< --seed <N>. The seed of the synthetic statements */
+    std::string textFile; /**< --text <file>. Real statement text, ie. from pdftotext, to run the classification stages on too */
+    std::string pdfDirectory; /**< --pdfs <directory>. Real statements to run the whole program on. Skipped if empty */
+};
+
+BenchmarkOptions parseOptions(const int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            throw Exception("Missing value for " + arg);
+        }
+        const std::string value = argv[++i];
+        if (arg == "--lines") {
+            options.lineCount = std::stoul(value);
+        }
+        else if (arg == "--iterations") {
+            options.iterations = std::max(1ul, std::stoul(value));
+        }
+        else if (arg == "--seed") {
+            options.seed = static_cast<uint32_t>(std::stoul(value));
+        }
+        else if (arg == "--text") {
+            options.textFile = std::filesystem::absolute(value).string();
+        }
+        else if (arg == "--pdfs") {
+            options.pdfDirectory = std::filesystem::absolute(value).string();
+        }
+        else {
+            throw Exception("Unknown argument \"" + arg + "\"");
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Runs a stage the given amount of times and prints how long it took.
+ *
+ * @param std::string The name of the stage.
+ * @param unsigned int The amount of times to run it.
+ * @param size_t The amount of items the stage handles per run. Used for the throughput.
+ * @param std::function Called before every run, and not timed.
+ * @param std::function The stage itself.
+ */
+void runStage(const std::string& name, const unsigned int iterations, const size_t items, const std::function<void()>& setup, const std::function<void()>& stage) {
+    double best = std::numeric_limits<double>::max();
+    double total = 0;
+    for (unsigned int i = 0; i < iterations; ++i) {
+        setup();
+        const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        stage();
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+        best = std::min(best, duration.count());
+        total += duration.count();
+    }
+    std::printf("%-28s best %10.3f ms   mean %10.3f ms   %12.0f items/s\n", name.c_str(), best, total / iterations, items / (best / 1000.0));
+}
+
+void fillStore(TransactionStore& store, const std::vector<std::string>& lines, const std::vector<LineMatch>& matches, size_t begin, size_t end, PdfProcessor& pdfProcessor) {
+    static const std::string LAST_FOUR = "1234";
+    for (size_t i = begin; i < end; ++i) {
+        const LineKind kind = matches[i].kind;
+        if (kind == LineKind::Transaction || kind == LineKind::TransactionInterest || kind == LineKind::TransactionOld) {
+            Transaction& transaction = store.add();
+            pdfProcessor.generateTransaction(&transaction, lines[i], matches[i], 2024, false, LAST_FOUR, store);
+        }
+    }
+}
+
+/**
+ * classify() runs the prefilter first. scan() and matchRegex() are also timed on their own to show what it saves.
+ */
+void runClassifierBenchmarks(const std::vector<std::string>& lines, const unsigned int iterations) {
+    size_t passed = 0;
+    for (const auto& line : lines) {
+        passed += LineClassifier::prefilter(line);
+    }
+    std::printf("%zu of %zu lines get past the prefilter\n", passed, lines.size());
+
+    volatile size_t sink = 0; // Keeps the classification from being optimized away
+    runStage("prefilter", iterations, lines.size(), [] {}, [&] {
+        for (const auto& line : lines) {
+            sink = sink + LineClassifier::prefilter(line);
+        }
+    });
+    runStage("scan (no prefilter)", iterations, lines.size(), [] {}, [&] {
+        for (const auto& line : lines) {
+            sink = sink + static_cast<size_t>(LineClassifier::scan(line).kind);
+        }
+    });
+    runStage("classify (scanner)", iterations, lines.size(), [] {}, [&] {
+        for (const auto& line : lines) {
+            sink = sink + static_cast<size_t>(LineClassifier::classify(line, ClassifierMode::Scanner).kind);
+        }
+    });
+    runStage("matchRegex (no prefilter)", iterations, lines.size(), [] {}, [&] {
+        for (const auto& line : lines) {
+            sink = sink + static_cast<size_t>(LineClassifier::matchRegex(line).kind);
+        }
+    });
+    runStage("classify (regex)", iterations, lines.size(), [] {}, [&] {
+        for (const auto& line : lines) {
+            sink = sink + static_cast<size_t>(LineClassifier::classify(line, ClassifierMode::Regex).kind);
+        }
+    });
+}
+
+void runTextBenchmark(const BenchmarkOptions& options) {
+    std::ifstream text(options.textFile);
+    if (!text) {
+        throw Exception("Couldn't open " + options.textFile);
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(text, line)) {
+        lines.push_back(line);
+    }
+    std::printf("Statement text: %s, %zu lines\n", options.textFile.c_str(), lines.size());
+    runClassifierBenchmarks(lines, options.iterations);
+}
+
+void runSyntheticBenchmarks(const BenchmarkOptions& options) {
+    StatementGenerator::Config config;
+    config.seed = options.seed;
+    StatementGenerator generator(config);
+
+    std::vector<std::string> lines;
+    lines.reserve(options.lineCount);
+    for (size_t i = 0; i < options.lineCount; ++i) {
+        lines.push_back(generator.generateLine());
+    }
+    std::printf("Synthetic statements: %zu lines, %zu lines per statement\n", lines.size(), config.linesPerStatement);
+
+    runClassifierBenchmarks(lines, options.iterations);
+
+    std::vector<LineMatch> matches;
+    matches.reserve(lines.size());
+    for (const auto& line : lines) {
+        matches.push_back(LineClassifier::scan(line));
+    }
+
+    // Each statement becomes its own run, just like processPdfs() does
+    PdfProcessor pdfProcessor;
+    std::vector<TransactionStore> statements;
+    const auto generateStatements = [&] {
+        statements.clear();
+        for (size_t begin = 0; begin < lines.size(); begin += config.linesPerStatement) {
+            statements.emplace_back();
+            fillStore(statements.back(), lines, matches, begin, std::min(begin + config.linesPerStatement, lines.size()), pdfProcessor);
+        }
+    };
+
+    size_t transactionCount = 0;
+    generateStatements();
+    for (const auto& statement : statements) {
+        transactionCount += statement.size();
+    }
+    runStage("generateTransaction", options.iterations, transactionCount, [&] { statements.clear(); }, generateStatements);
+
+    runStage("sortTransactions", options.iterations, transactionCount, [&] {
+        generateStatements();
+        pdfProcessor.getTransactions().clear();
+        for (auto& statement : statements) {
+            pdfProcessor.getTransactions().append(std::move(statement));
+        }
+    }, [&] { pdfProcessor.sortTransactions(); });
+
+    runStage("generateCsvFile", options.iterations, transactionCount, [] {}, [&] { pdfProcessor.generateCsvFile("benchmark.csv"); });
+}
+
+/**
+ * Runs the same steps as main(), on a fresh PdfProcessor every time.
+ */
+void runPdfBenchmark(const BenchmarkOptions& options) {
+    size_t fileCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(options.pdfDirectory)) {
+        fileCount += entry.is_regular_file();
+    }
+    std::printf("PDF statements: %s\n", options.pdfDirectory.c_str());
+
+    runStage("end to end", options.iterations, fileCount, [] {}, [&] {
+        PdfProcessor pdfProcessor;
+        pdfProcessor.gatherPdfFiles({options.pdfDirectory});
+        pdfProcessor.closeSkippedFilesFile();
+        pdfProcessor.processPdfs(options.pdfDirectory);
+        pdfProcessor.closeSkippedLinesFile();
+        pdfProcessor.sortTransactions();
+        pdfProcessor.generateCsvFile(constants::CSV_FILE_NAME);
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    LOG_VERIFY
+    std::thread logThread = rk::log::startLogThread();
+    int status = 0;
+
+    try {
+        const BenchmarkOptions options = parseOptions(argc, argv);
+
+        const std::filesystem::path workDirectory = std::filesystem::temp_directory_path() / "wells_fargo_benchmark";
+        std::filesystem::create_directories(workDirectory / constants::OUTPUT_DIRECTORY);
+        std::filesystem::current_path(workDirectory);
+
+        runSyntheticBenchmarks(options);
+        if (!options.textFile.empty()) {
+            runTextBenchmark(options);
+        }
+        if (!options.pdfDirectory.empty()) {
+            runPdfBenchmark(options);
+        }
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+        status = 1;
+    }
+
+    rk::log::endLogThread(logThread);
+    rk::log::closeLogFile();
+    return status;
+}
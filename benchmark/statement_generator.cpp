@@ -0,0 +1,77 @@
+/**
+ * @file statement_generator.cpp
+ * @brief Source file for the StatementGenerator class.
+ */
+#include <cstdio>
+#include "statement_generator.h"
+#include "wells_fargo_statement_converter/constants.h"
+
+namespace {
+
+const std::vector<std::string> NAMES = {"MCDONALDS RESTAURANT", "AMAZON MKTPLACE PMTS AMZN.COM/BILL WA", "SHELL OIL 57444", "TRADER JOE S #123  SAN JOSE CA",
+                                        "COSTCO WHSE #0001", "NETFLIX.COM", "UBER   *TRIP HELP.UBER.COM CA", "SQ *BLUE BOTTLE COFFEE"};
+const std::vector<std::string> TEXT = {"Transactions", "continued", "Trans Post Reference Number Description Credits Charges",
+                                       "Notice: See reverse side for important information.", "Page 2 of 4"};
+const std::vector<std::string> RELEVANT = {"TOTAL PURCHASES, BALANCE TRANSFERS & OTHER CHARGES FOR THIS PERIOD $1,234.56", "Minimum Payment $35.00",
+                                           "Fees Charged $0.00", "Total Interest for This Period 12.34"};
+
+enum Kind { TRANSACTION, OLD_TRANSACTION, INTEREST, SKIP_LIST, RELEVANT_LINE, IRRELEVANT_LINE };
+
+} // namespace
+
+StatementGenerator::StatementGenerator(const Config& pConfig)
+    : config(pConfig), random(pConfig.seed),
+      kindDistribution({pConfig.transactionShare, pConfig.oldTransactionShare, pConfig.interestShare, pConfig.skipListShare, pConfig.relevantShare, pConfig.irrelevantShare}) {}
+
+std::string StatementGenerator::generateLine() {
+    switch (kindDistribution(random)) {
+        case TRANSACTION:
+            return "1234 " + generateDate() + " " + generateDate() + " " + generateRefNum() + " " + pick(NAMES) + " " + generateAmount();
+        case OLD_TRANSACTION:
+            return generateDate() + " " + generateDate() + " " + generateRefNum() + " " + pick(NAMES) + " " + generateAmount();
+        case INTEREST:
+            return generateDate() + " " + generateDate() + " " + constants::regex::INTEREST_CHARGE + " " + generateAmount();
+        case SKIP_LIST:
+            return "1234 " + generateDate() + " " + generateDate() + " " + generateRefNum() + " " +
+                ((random() % 2) ? constants::regex::ONLINE_PAYMENT + " - THANK YOU" : constants::regex::LAST_STATEMENT_BALANCE + " 1234") + " " + generateAmount();
+        case RELEVANT_LINE:
+            return pick(RELEVANT);
+        default:
+            return pick(TEXT);
+    }
+}
+
+std::string StatementGenerator::generateDate() {
+    char date[6];
+    std::snprintf(date, sizeof(date), "%02u/%02u", static_cast<unsigned int>(random() % 12 + 1), static_cast<unsigned int>(random() % 28 + 1));
+    return date;
+}
+
+/**
+ * Most amounts are small, but some are large enough to have a comma.
+ */
+std::string StatementGenerator::generateAmount() {
+    const unsigned int cents = random() % 100;
+    const unsigned int dollars = (random() % 10 == 0) ? random() % 20000 : random() % 200;
+    char amount[32];
+    if (dollars >= 1000) {
+        std::snprintf(amount, sizeof(amount), "%u,%03u.%02u", dollars / 1000, dollars % 1000, cents);
+    }
+    else {
+        std::snprintf(amount, sizeof(amount), "%u.%02u", dollars, cents);
+    }
+    return amount;
+}
+
+std::string StatementGenerator::generateRefNum() {
+    static const char CHARACTERS[] = "ABCDEFGHJKLMNPQRSTUVWXYZ0123456789";
+    std::string refNum(constants::REF_NUM_SIZE, ' ');
+    for (char& c : refNum) {
+        c = CHARACTERS[random() % (sizeof(CHARACTERS) - 1)];
+    }
+    return refNum;
+}
+
+const std::string& StatementGenerator::pick(const std::vector<std::string>& options) {
+    return options[random() % options.size()];
+}
@@ -0,0 +1,61 @@
+/**
+ * @file statement_generator.h
+ * @brief Header file for the StatementGenerator class.
+ */
+#ifndef STATEMENT_GENERATOR_H
+#define STATEMENT_GENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @class StatementGenerator
+ * @brief Generates synthetic statement text that looks like what Poppler extracts from a Wells Fargo statement.
+ * 
+ * The text covers every kind of line the parser knows about: new and old format transactions, interest charges,
+ * lines from the skip list, possibly relevant lines and plain text.
+ */
+class StatementGenerator {
+public:
+    /**
+     * @struct Config
+     * @brief How much of each kind of line to generate. The shares are relative to one another.
+     */
+    struct Config {
+        size_t linesPerStatement = 200; /**< The number of lines in the transaction section of each statement. Each statement becomes its own run for the sort */
+        double transactionShare = 0.55; /**< New format transactions */
+        double oldTransactionShare = 0.1; /**< Old format transactions */
+        double interestShare = 0.02;
+        double skipListShare = 0.05; /**< Transactions that are in constants::regex::SKIP_LIST */
+        double relevantShare = 0.08; /**< Lines with amounts or dollar signs that aren't transactions */
+        double irrelevantShare = 0.2; /**< Plain text */
+        uint32_t seed = 1;
+    };
+
+    /**
+     * @brief Constructor.
+     * 
+     * @param Config What to generate.
+     */
+    explicit StatementGenerator(const Config&);
+
+    /**
+     * @brief Generates a single line from the transaction section of a statement.
+     * 
+     * @return The line, without a newline at the end.
+     */
+    std::string generateLine();
+private:
+    std::string generateDate();
+    std::string generateAmount();
+    std::string generateRefNum();
+    const std::string& pick(const std::vector<std::string>&);
+
+    Config config;
+    std::mt19937 random;
+    std::discrete_distribution<int> kindDistribution;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file columnar_writer.h
+ * @brief Header file for the ColumnarWriter class.
+ */
+#ifndef COLUMNAR_WRITER_H
+#define COLUMNAR_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "transaction.h"
+
+/**
+ * @class ColumnarWriter
+ * @brief Writes transactions to a binary file that stores each field as its own column, so it can be memory-mapped and
+ * scanned without parsing.
+ *
+ * Numbers are in the byte order of the machine that wrote the file, which is little-endian on x86 and ARM. Every column
+ * starts at a multiple of 8 bytes from the start of the file. The file starts with a header:
+ * - 8 bytes: the magic "WFCOLUMN".
+ * - uint32: the format version, COLUMNAR_VERSION.
+ * - uint32: 0x01020304, to check the byte order.
+ * - uint64: the number of rows.
+ * - uint32: the number of accounts in the account dictionary.
+ * - uint32: the width of a reference number, constants::REF_NUM_SIZE.
+ * - 7 x uint64: the offsets of the columns below, in that order.
+ *
+ * The columns are:
+ * - Dates: a uint32 per row, in the form YYYYMMDD. See Date::getKey().
+ * - Amounts: an int64 per row, in cents, with the same sign as in the CSV file. ie. -15.34 is -1534.
+ * - Accounts: a uint16 per row, the index of its last four in the account dictionary.
+ * - Account dictionary: constants::LAST_FOUR_SIZE bytes per account, padded with zeros.
+ * - Reference numbers: constants::REF_NUM_SIZE bytes per row, padded with zeros. Interest charges have none.
+ * - Name offsets: rows + 1 uint64s. Row i's name is the bytes from offset i up to offset i + 1 in the names.
+ * - Names: every name one after another, without separators.
+ *
+ * The columns are kept in memory until close(). They take up much less than the transactions did, but they grow with
+ * every row, even when the transactions are spilled under PdfProcessor::setMemoryBudget().
+ */
+class ColumnarWriter {
+public:
+    static constexpr uint32_t COLUMNAR_VERSION = 1; /**< Bump this whenever the layout changes */
+
+    /**
+     * @brief Constructor. Opens the file.
+     *
+     * Throws an Exception if the file can't be opened.
+     *
+     * @param std::string The path of the file to write.
+     */
+    explicit ColumnarWriter(const std::string&);
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    /**
+     * @brief Adds a transaction as the next row.
+     *
+     * Throws an Exception if there are more accounts than fit in the account column.
+     *
+     * @param Transaction The transaction.
+     */
+    void write(const Transaction&);
+
+    /**
+     * @brief Writes the header and the columns to the file and closes it. Throws an Exception if anything couldn't be
+     * written.
+     */
+    void close();
+private:
+    std::string path;
+    std::ofstream file;
+    std::vector<uint32_t> dates;
+    std::vector<int64_t> amounts;
+    std::vector<uint16_t> accounts;
+    std::string accountDictionary;
+    std::unordered_map<std::string, uint16_t> accountIndices; /**< Where each last four is in the account dictionary */
+    std::string referenceNums;
+    std::vector<uint64_t> nameOffsets;
+    std::string names;
+};
+
+#endif
@@ -5,44 +5,51 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include <cstdint>
 #include <string>
-#include <regex>
 
 namespace constants {
 
 // Known values
 constexpr size_t REF_NUM_SIZE = 17; /**< The amount of characters in a reference number */
+constexpr size_t LAST_FOUR_SIZE = 4; /**< The amount of characters in the last four of an account */
+constexpr uint32_t PARSER_VERSION = 3; /**< Bump this whenever a change to the parser changes its output. It invalidates the statement cache */
+constexpr unsigned int WATCH_SETTLE_TIME_MS = 500; /**< In watch mode, how long files have to stay the same before they are picked up, so statements that are still downloading are left alone */
 
 // File and directory names
 inline const std::string OUTPUT_DIRECTORY = "output";
 inline const std::string PDF_DIRECTORY = "statements_pdf";
 inline const std::string CSV_FILE_NAME = "combined_statements.csv";
+inline const std::string COLUMNAR_FILE_EXTENSION = ".wfcol"; /**< The columnar file from --columnar has the CSV file's name with this extension */
 inline const std::string SKIPPED_LINES_FILE_NAME = "skipped_lines.txt";
 inline const std::string SKIPPED_FILES_FILE_NAME = "skipped_files.txt";
+inline const std::string STATISTICS_FILE_NAME = "statistics.json";
+inline const std::string SUMMARY_FILE_NAME = "summary.csv";
+inline const std::string TRACE_FILE_NAME = "trace.json";
+inline const std::string ACCOUNT_DIRECTORY = "accounts"; /**< The CSV files per account from --per-account. Lives inside OUTPUT_DIRECTORY */
+inline const std::string UNKNOWN_ACCOUNT = "unknown"; /**< The file name used for transactions without a last four */
+inline const std::string CACHE_DIRECTORY = "cache"; /**< Lives inside OUTPUT_DIRECTORY */
+inline const std::string SPILL_FILE_PREFIX = "spill_"; /**< The sorted runs that are written with a memory budget. They live inside OUTPUT_DIRECTORY and are removed once the CSV file is written */
 
 namespace regex {
 
-    // Patterns
+    // Patterns. They are matched by hand-written code. Only ClassifierMode::Regex and ClassifierMode::Verify compile them with std::regex
+    inline constexpr size_t PDF_FILE_NAME_DATE_SIZE = 6; /**< The "MMDDYY" at the start of a statement's file name */
+    inline const std::string PDF_FILE_NAME_SUFFIX = " WellsFargo.pdf";
     inline const std::string PDF_FILE_NAME = "[0-9]{6} WellsFargo\\.pdf"; /**< ie. "102324 WellsFargo.pdf". Represents the standard file name pattern used by Wells Fargo when downloading statements from them */
     inline const std::string TRANSACTION = "^\\s*(\\d+)\\s+(\\d{2}/\\d{2})\\s+(\\d{2}/\\d{2})\\s+(\\S+)\\s+(.+?)\\s+((\\d|,)+\\.\\d{2})\\s*$";
     inline const std::string TRANSACTION_OLD = "^\\s*(\\d{2}/\\d{2})\\s+(\\d{2}/\\d{2})\\s+(\\S+)\\s+(.+?)\\s+((\\d|,)+\\.\\d{2})\\s*$"; /**< wells Fargo switched their format around August 2023. Old format didn't have last 4 of card for each transaction */
-    inline const std::string TRANSACTION_INTEREST = "^\\s*(\\d{2}/\\d{2})\\s+(\\d{2}/\\d{2})\\s+INTEREST CHARGE ON PURCHASES\\s+((\\d|,)+\\.\\d{2})\\s*$"; // Interest charges don't have "card ending in" or "reference num"
+    inline const std::string INTEREST_CHARGE = "INTEREST CHARGE ON PURCHASES";
+    inline const std::string TRANSACTION_INTEREST = "^\\s*(\\d{2}/\\d{2})\\s+(\\d{2}/\\d{2})\\s+" + INTEREST_CHARGE + "\\s+((\\d|,)+\\.\\d{2})\\s*$"; // Interest charges don't have "card ending in" or "reference num"
     inline const std::string TRANSACTION_SECTION_TITLE = "Purchases, Balance Transfers & Other Charges"; /**< This text comes before transactions are listed */
+    inline const std::string TRANSACTION_SECTION_END = "Totals Year-to-Date"; /**< This text comes after the last transactions, including the interest charges */
     inline const std::string ONLINE_PAYMENT = "ONLINE PAYMENT";
     inline const std::string LAST_STATEMENT_BALANCE = "LAST STATEMENT BAL FROM ACCT ENDING";
     inline const std::string SKIP_LIST = "(" + ONLINE_PAYMENT + "|" + LAST_STATEMENT_BALANCE + ")"; /**< These are patterns that will match the transaction pattern, but are not needed, so they are added to this pattern to skip them explicitly */
     inline const std::string SKIPPED_RELEVANT = "((\\d|,)+\\.\\d{2})|(\\$+)"; /**< For capturing lines that were possibly skipped on accident */
-    inline const std::string LAST_FOUR = "(Ending in|Account ending in)";
-
-    // Regex objects
-    const std::regex pdfFilePattern(PDF_FILE_NAME);
-    const std::regex transactionPattern(TRANSACTION);
-    const std::regex transactionPatternOld(TRANSACTION_OLD);
-    const std::regex transactionPatternInterest(TRANSACTION_INTEREST);
-    const std::regex transactionTitlePattern(TRANSACTION_SECTION_TITLE);
-    const std::regex transactionSkip(SKIP_LIST);
-    const std::regex transactionPatternSkippedRelevant(SKIPPED_RELEVANT);
-    const std::regex lastFourPattern(LAST_FOUR);
+    inline const std::string ENDING_IN = "Ending in";
+    inline const std::string ACCOUNT_ENDING_IN = "Account ending in";
+    inline const std::string LAST_FOUR = "(" + ENDING_IN + "|" + ACCOUNT_ENDING_IN + ")";
 
 } // namespace regex
 
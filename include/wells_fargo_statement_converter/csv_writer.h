@@ -0,0 +1,72 @@
+/**
+ * @file csv_writer.h
+ * @brief Header file for the CsvWriter class.
+ */
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include "transaction.h"
+
+/**
+ * @class CsvWriter
+ * @brief Writes transactions to a CSV file through a large reusable buffer.
+ * 
+ * Rows are formatted straight into the buffer, which is written to the file in big chunks whenever it fills up. Text
+ * that is already a big chunk is written to the file directly instead of being copied into the buffer.
+ */
+class CsvWriter {
+public:
+    /**
+     * @brief Constructor. Opens the file.
+     * 
+     * Throws an Exception if the file can't be opened.
+     * 
+     * @param std::string The path of the file to write.
+     * @param bool Whether to add to the end of the file instead of overwriting it.
+     */
+    explicit CsvWriter(const std::string&, const bool append = false);
+
+    /**
+     * @brief Destructor. Writes whatever is left in the buffer.
+     */
+    ~CsvWriter();
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    /**
+     * @brief Adds a transaction as a row, followed by a newline.
+     * 
+     * @param Transaction The transaction.
+     */
+    void write(const Transaction&);
+
+    /**
+     * @brief Adds text to the file as is.
+     * 
+     * @param std::string_view The text.
+     */
+    void write(const std::string_view);
+
+    /**
+     * @brief Writes the buffer to the file.
+     */
+    void flush();
+
+    /**
+     * @brief Writes the buffer to the file and closes it. Throws an Exception if anything couldn't be written.
+     */
+    void close();
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 20; /**< The buffer is written out once it holds this many bytes */
+    static constexpr size_t DIRECT_WRITE_SIZE = BUFFER_SIZE / 4; /**< Text at least this long skips the buffer */
+
+    std::string path;
+    std::ofstream file;
+    std::string buffer;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef DATE_H
 #define DATE_H
 
+#include <cstdint>
 #include <string>
 
 /**
@@ -39,7 +40,7 @@ public:
      * 
      * @return The formatted date.
      */
-    std::string getDateString();
+    std::string getDateString() const;
 
     /**
      * @brief Overloaded assignment operator.
@@ -61,26 +62,35 @@ public:
      */
     bool operator<=(const Date& other) const;
 
+    /**
+     * @brief Packs the date into a single number that sorts chronologically, in the form YYYYMMDD.
+     * 
+     * Ex. April 18th 2023 becomes 20230418.
+     * 
+     * @return The packed date.
+     */
+    uint32_t getKey() const;
+
     /**
      * @brief Getter for year.
      * 
      * @return Year value.
      */
-    int const getYear();
+    int getYear() const;
 
     /**
      * @brief Getter for month.
      * 
      * @return Month value.
      */
-    int const getMonth();
+    int getMonth() const;
 
     /**
      * @brief Getter for day.
      * 
      * @return Day value.
      */
-    int const getDay();
+    int getDay() const;
 private:
     int year;
     int month;
@@ -0,0 +1,101 @@
+/**
+ * @file directory_watcher.h
+ * @brief Header file for the DirectoryWatcher class.
+ */
+#ifndef DIRECTORY_WATCHER_H
+#define DIRECTORY_WATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @class DirectoryWatcher
+ * @brief Waits for files in a directory to be added, changed or removed.
+ * 
+ * On Linux, inotify wakes the watcher up as soon as something in the directory changes. Everywhere else, or if inotify
+ * isn't available, the directory is polled. Either way, the directory is listed and compared to the last listing to find
+ * out what changed, and it is listed again until it stops changing, so files that are still being written aren't reported
+ * halfway through.
+ */
+class DirectoryWatcher {
+public:
+    /**
+     * @struct Changes
+     * @brief The paths of the files that changed since the last call to waitForChanges(), in alphabetical order.
+     */
+    struct Changes {
+        std::vector<std::string> added;
+        std::vector<std::string> modified;
+        std::vector<std::string> removed;
+
+        /**
+         * @brief Whether or not nothing changed.
+         * 
+         * @return true if every list is empty.
+         */
+        bool empty() const;
+    };
+
+    /**
+     * @brief Constructor. Lists the directory, so only changes made from now on are reported.
+     * 
+     * @param std::string The directory to watch. Only files directly inside it are watched.
+     * @param std::chrono::milliseconds How often the directory is polled, and how often the stop flag is checked with inotify.
+     */
+    DirectoryWatcher(const std::string&, const std::chrono::milliseconds);
+
+    /**
+     * @brief Destructor. Stops watching the directory.
+     */
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    /**
+     * @brief Blocks until files in the directory change, or until stop is set.
+     * 
+     * @param std::atomic<bool> Checked at least once per poll interval. It can be set from a signal handler.
+     * 
+     * @return The changes. Empty if it stopped because of the stop flag.
+     */
+    Changes waitForChanges(const std::atomic<bool>&);
+private:
+    /**
+     * @brief What a file looked like when the directory was listed. Files count as changed when either part changes.
+     */
+    struct FileState {
+        std::uintmax_t size = 0;
+        std::filesystem::file_time_type writeTime;
+
+        bool operator==(const FileState&) const;
+    };
+
+    typedef std::map<std::string, FileState> Listing;
+
+    /**
+     * @brief Lists the regular files in the directory. A directory that can't be listed, ie. because it was removed, is empty.
+     * 
+     * @return The files by path.
+     */
+    Listing list() const;
+
+    /**
+     * @brief Waits for a notification from inotify, or for the poll interval to pass.
+     * 
+     * @return Whether or not the directory should be listed again.
+     */
+    bool waitForEvent();
+
+    std::string directory;
+    std::chrono::milliseconds pollInterval;
+    Listing files; /**< The files as of the last reported change */
+    int notifyFd = -1; /**< The inotify instance. -1 if the directory is polled */
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file external_merge.h
+ * @brief Header file for the ExternalMerge class.
+ */
+#ifndef EXTERNAL_MERGE_H
+#define EXTERNAL_MERGE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "transaction.h"
+
+/**
+ * @class ExternalMerge
+ * @brief Sorts more transactions than fit in memory, by writing sorted runs of them to spill files and merging those.
+ * 
+ * Each spill file holds one run, sorted by Date::getKey(). The runs are merged in the order they were spilled, and ties
+ * are broken by that order, so the result is the same as a stable sort of all of the runs one after another. Only a small
+ * buffer per run is in memory while merging. If there are too many runs to open at once, groups of them are merged into
+ * bigger runs first.
+ * 
+ * The merge can also drop a transaction when an earlier run already had the same one (see TransactionIndex). The runs are
+ * expected to be deduplicated on their own, so the copies of a transaction within one run all come from one statement, and
+ * are all kept. Groups are deduplicated the same way when they are merged, which keeps that true for the bigger runs.
+ */
+class ExternalMerge {
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param std::string The directory that the spill files are written to. It must exist.
+     */
+    explicit ExternalMerge(const std::string&);
+
+    /**
+     * @brief Destructor. Removes the spill files that are left.
+     */
+    ~ExternalMerge();
+
+    ExternalMerge(const ExternalMerge&) = delete;
+    ExternalMerge& operator=(const ExternalMerge&) = delete;
+
+    /**
+     * @brief Writes a run of transactions to a new spill file. Throws an Exception if it can't be written.
+     * 
+     * @param std::vector<Transaction> The run. It must be sorted by Date::getKey().
+     */
+    void spill(const std::vector<Transaction>&);
+
+    /**
+     * @brief The number of runs that were spilled and not merged yet.
+     * 
+     * @return The number of runs.
+     */
+    size_t getRunCount() const;
+
+    /**
+     * @brief Merges every spilled run, followed by one more run that is still in memory, and removes the spill files.
+     * 
+     * @param std::vector<Transaction> The run in memory, sorted by Date::getKey(). It comes after the spilled runs.
+     * @param bool Whether or not to drop the transactions that an earlier run already had.
+     * @param std::function Called with each transaction in sorted order. The transaction's name is only valid during the call.
+     * 
+     * @return The number of transactions that were dropped.
+     */
+    size_t merge(const std::vector<Transaction>&, const bool, const std::function<void(const Transaction&)>&);
+private:
+    static constexpr size_t MAX_MERGE_WIDTH = 64; /**< The most spill files that are open at the same time */
+
+    /**
+     * @brief Merges runs into a sink.
+     * 
+     * @param std::vector<std::string> The spill files of the runs, in order.
+     * @param std::vector<Transaction> A run in memory that comes after them. Can be empty.
+     * @param bool Whether or not to drop the transactions that an earlier run already had.
+     * @param std::function Called with each transaction in sorted order.
+     * 
+     * @return The number of transactions that were dropped.
+     */
+    size_t mergeRuns(const std::vector<std::string>&, const std::vector<Transaction>&, const bool, const std::function<void(const Transaction&)>&);
+
+    /**
+     * @brief Comes up with the path of a new spill file.
+     * 
+     * @return The path.
+     */
+    std::string nextPath();
+
+    std::string directory;
+    std::vector<std::string> runFiles; /**< The spill files that still need to be merged, in order */
+    size_t fileCount = 0; /**< Used to name the spill files */
+};
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file json.h
+ * @brief Header file for the helpers that the JSON reports, ie. --stats and --trace, are written with.
+ */
+#ifndef JSON_H
+#define JSON_H
+
+#include <ostream>
+#include <string_view>
+
+namespace json {
+
+/**
+ * @brief Writes a string as a JSON string, in quotes, escaping what needs to be escaped.
+ * 
+ * Quotes and backslashes get a backslash in front, and control characters are written as \uXXXX. Everything else,
+ * including UTF-8, is written as it is.
+ * 
+ * @param std::ostream Where to write it. Its formatting flags are left as they were.
+ * @param std::string_view The string.
+ */
+void writeString(std::ostream&, const std::string_view);
+
+} // namespace json
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file line_classifier.h
+ * @brief Header file for the LineClassifier class.
+ */
+#ifndef LINE_CLASSIFIER_H
+#define LINE_CLASSIFIER_H
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief The kinds of lines that can be found in the transaction section of a statement.
+ */
+enum class LineKind {
+    Transaction, /**< Matches constants::regex::TRANSACTION */
+    TransactionInterest, /**< Matches constants::regex::TRANSACTION_INTEREST */
+    TransactionOld, /**< Matches constants::regex::TRANSACTION_OLD */
+    SkipListed, /**< Matches one of the transaction patterns, but is in constants::regex::SKIP_LIST */
+    SkippedRelevant, /**< Doesn't match, but matches constants::regex::SKIPPED_RELEVANT */
+    Irrelevant /**< Anything else */
+};
+
+/**
+ * @brief Selects how lines are classified.
+ */
+enum class ClassifierMode {
+    Scanner, /**< The hand-written single-pass scanner */
+    Regex, /**< The std::regex patterns from constants::regex */
+    Verify /**< Runs both, logs any disagreement, and uses the regex result */
+};
+
+/**
+ * @struct FieldSpan
+ * @brief The position of a field within a line.
+ */
+struct FieldSpan {
+    size_t offset = 0;
+    size_t length = 0;
+
+    bool operator==(const FieldSpan& other) const {
+        return offset == other.offset && length == other.length;
+    }
+};
+
+/**
+ * @struct LineMatch
+ * @brief The kind of a line and the positions of the fields that were found in it.
+ *
+ * The fields follow the capture groups of the transaction pattern that matched. Fields that the pattern doesn't have,
+ * like the last four of an old format transaction, are left empty. SkipListed lines keep the fields of the pattern they
+ * matched.
+ */
+struct LineMatch {
+    LineKind kind = LineKind::Irrelevant;
+    FieldSpan lastFour; /**< The card number column of the new format */
+    FieldSpan transactionDate;
+    FieldSpan postDate;
+    FieldSpan referenceNum;
+    FieldSpan name;
+    FieldSpan amount;
+
+    bool operator==(const LineMatch& other) const {
+        return kind == other.kind && lastFour == other.lastFour && transactionDate == other.transactionDate && postDate == other.postDate
+            && referenceNum == other.referenceNum && name == other.name && amount == other.amount;
+    }
+};
+
+/**
+ * @struct PageFeatures
+ * @brief What a quick scan over the whole text of a page found.
+ */
+struct PageFeatures {
+    bool hasLastFour = false; /**< Some line matches constants::regex::LAST_FOUR */
+    bool hasTitle = false; /**< Some line matches constants::regex::TRANSACTION_SECTION_TITLE */
+    bool hasRelevant = false; /**< Some line matches constants::regex::SKIPPED_RELEVANT. Every transaction line does too */
+    bool hasSectionEnd = false; /**< Some line contains constants::regex::TRANSACTION_SECTION_END */
+};
+
+/**
+ * @class LineClassifier
+ * @brief Decides what a line extracted from a statement is.
+ */
+class LineClassifier {
+public:
+    /**
+     * @brief Classifies a line from the transaction section of a statement.
+     *
+     * @param std::string_view The line.
+     * @param ClassifierMode How to classify the line.
+     *
+     * @return The kind of the line and its fields.
+     */
+    static LineMatch classify(const std::string_view, const ClassifierMode);
+
+    /**
+     * @brief Quickly checks if a line can be anything other than LineKind::Irrelevant.
+     *
+     * Every transaction ends in an amount, and possibly relevant lines have an amount or a '$', so a line without either
+     * is irrelevant. classify() only runs the full patterns on lines that pass. Uses SSE2 or AVX2 when they are available.
+     *
+     * @param std::string_view The line.
+     *
+     * @return Whether or not the line needs to be classified.
+     */
+    static bool prefilter(const std::string_view);
+
+    /**
+     * @brief Classifies a line with the hand-written scanner, in a single left-to-right pass over the line.
+     *
+     * @param std::string_view The line.
+     *
+     * @return The kind of the line and its fields.
+     */
+    static LineMatch scan(const std::string_view);
+
+    /**
+     * @brief Classifies a line with the std::regex patterns from constants::regex.
+     *
+     * @param std::string_view The line.
+     *
+     * @return The kind of the line and its fields.
+     */
+    static LineMatch matchRegex(const std::string_view);
+
+    /**
+     * @brief Checks if the line holds the last four of the account (constants::regex::LAST_FOUR).
+     *
+     * @param std::string_view The line.
+     * @param ClassifierMode How to check the line.
+     *
+     * @return Whether or not the line matched.
+     */
+    static bool isLastFourLine(const std::string_view, const ClassifierMode);
+
+    /**
+     * @brief Checks if the line holds the transaction section title (constants::regex::TRANSACTION_SECTION_TITLE).
+     *
+     * @param std::string_view The line.
+     * @param ClassifierMode How to check the line.
+     *
+     * @return Whether or not the line matched.
+     */
+    static bool isTitleLine(const std::string_view, const ClassifierMode);
+
+    /**
+     * @brief Scans the whole text of a page for the patterns that decide whether any of its lines can matter.
+     * 
+     * A line that matches none of them is always skipped, so a page that has none of them can be skipped without
+     * classifying its lines.
+     * 
+     * @param std::string_view The text of the page.
+     * 
+     * @return What was found.
+     */
+    static PageFeatures scanPage(const std::string_view);
+
+    /**
+     * @brief The number of lines the scanner and the regex patterns disagreed on in ClassifierMode::Verify.
+     *
+     * @return The number of disagreements since the program started.
+     */
+    static size_t getMismatchCount();
+};
+
+#endif
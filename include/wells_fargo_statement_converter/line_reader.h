@@ -0,0 +1,55 @@
+/**
+ * @file line_reader.h
+ * @brief Header file for the LineReader class.
+ */
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @class LineReader
+ * @brief Walks through text one line at a time, without copying it.
+ * 
+ * The lines are the same ones std::getline() would produce: they are split on '\n', which is dropped, and a '\n' at the
+ * very end doesn't produce an extra empty line. Everything else, like '\r', is kept. It's defined in the header since
+ * it's called for every line of every page.
+ */
+class LineReader {
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param std::string_view The text. It has to outlive the reader and the lines it hands out.
+     */
+    explicit LineReader(const std::string_view pText) : text(pText) {}
+
+    /**
+     * @brief Moves to the next line.
+     * 
+     * @param std::string_view Set to the next line, if there is one.
+     * 
+     * @return Whether or not there was another line.
+     */
+    bool next(std::string_view& line) {
+        if (position >= text.size()) {
+            return false;
+        }
+        const size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            line = text.substr(position);
+            position = text.size();
+        }
+        else {
+            line = text.substr(position, end - position);
+            position = end + 1;
+        }
+        return true;
+    }
+private:
+    std::string_view text;
+    size_t position = 0;
+};
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file log_level.h
+ * @brief Leveled logging macros on top of RK_Logger's LOG().
+ * 
+ * Every call is tagged with a level. Calls below MIN_LOG_LEVEL are removed by the preprocessor, arguments and all,
+ * so they cost nothing at run time. MIN_LOG_LEVEL can be set on the command line, ie. -DMIN_LOG_LEVEL=LOG_LEVEL_ERROR.
+ * Otherwise it is LOG_LEVEL_INFO for release builds (NDEBUG) and LOG_LEVEL_TRACE for everything else.
+ */
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+#include "logger/log.h"
+
+#define LOG_LEVEL_TRACE 0 /**< Every line, field and transaction */
+#define LOG_LEVEL_DEBUG 1 /**< Every file and page */
+#define LOG_LEVEL_INFO 2 /**< The steps of the program and their summaries */
+#define LOG_LEVEL_ERROR 3 /**< Something failed */
+#define LOG_LEVEL_NONE 4
+
+#ifndef MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define MIN_LOG_LEVEL LOG_LEVEL_INFO
+#else
+#define MIN_LOG_LEVEL LOG_LEVEL_TRACE
+#endif
+#endif
+
+#if MIN_LOG_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) LOG(__VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void)0)
+#endif
+
+#if MIN_LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if MIN_LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG(__VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if MIN_LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file name_interner.h
+ * @brief Header file for the NameInterner class.
+ */
+#ifndef NAME_INTERNER_H
+#define NAME_INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "string_arena.h"
+
+/**
+ * @class NameInterner
+ * @brief Gives every distinct string a small number, so strings can be grouped and compared as integers.
+ *
+ * The numbers are handed out in order, starting at 0, so they can be used as indices into a vector. Each string is
+ * copied into an arena once. Lookups go through a flat, open-addressed table of numbers, each with part of its hash, so
+ * most collisions are told apart without comparing the strings.
+ */
+class NameInterner {
+public:
+    /**
+     * @brief Looks up the number of a string, giving it the next one if it wasn't seen before.
+     *
+     * @param std::string_view The string. It doesn't have to stay valid afterwards.
+     *
+     * @return The number.
+     */
+    uint32_t intern(const std::string_view);
+
+    /**
+     * @brief Getter for the string with a number.
+     *
+     * @param uint32_t The number, from intern().
+     *
+     * @return The string. It stays valid until clear().
+     */
+    std::string_view getName(const uint32_t) const;
+
+    /**
+     * @brief The number of distinct strings.
+     *
+     * @return The number of strings.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Forgets every string and frees the memory.
+     */
+    void clear();
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX; /**< The number of a slot that is not in use */
+
+    /**
+     * @struct Slot
+     * @brief A number in the table.
+     */
+    struct Slot {
+        uint32_t id = EMPTY;
+        uint32_t tag = 0; /**< The upper half of the hash. The lower half picks the slot */
+    };
+
+    /**
+     * @brief Hashes a string.
+     *
+     * @param std::string_view The string.
+     *
+     * @return The hash.
+     */
+    static uint64_t hash(const std::string_view);
+
+    /**
+     * @brief Doubles the size of the table and puts every number back into it.
+     */
+    void grow();
+
+    std::vector<Slot> slots; /**< Always a power of 2, so the hash can be masked to pick a slot */
+    std::vector<std::string_view> names; /**< The strings, by number. They point into the arena */
+    StringArena arena;
+};
+
+#endif
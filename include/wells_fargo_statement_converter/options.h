@@ -0,0 +1,52 @@
+/**
+ * @file options.h
+ * @brief Header file for the Options struct.
+ */
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+#include <vector>
+#include "thread_pool.h"
+#include "line_classifier.h"
+#include "text_region.h"
+
+/**
+ * @struct Options
+ * @brief The settings that can be passed to the program on the command line.
+ */
+struct Options {
+    std::vector<std::string> inputDirectories; /**< --input <directory>. Can be passed more than once. Defaults to statements_pdf */
+    bool recursive = false; /**< --recursive. Look for statements in the subdirectories of the input directories too */
+    unsigned int threadCount = ThreadPool::defaultThreadCount(); /**< --threads <N>. The number of PDF statements processed at the same time */
+    unsigned int pageThreadCount = 1; /**< --page-threads <N>. The number of threads the pages of a single statement are split across */
+    unsigned int prefetchCount = 0; /**< --prefetch <N>. The number of statements read into memory ahead of the ones being parsed */
+    bool pagePruning = true; /**< --no-page-pruning disables it. Skip pages that can't contribute anything without classifying their lines */
+    bool stopAtSectionEnd = false; /**< --stop-at-section-end. Ignore the rest of a statement once its transactions have ended */
+    TextRegion textRegion; /**< --text-region <x,y,width,height>. Only extract text from this part of each page */
+    ClassifierMode classifierMode = ClassifierMode::Scanner; /**< --classifier <scanner|regex|verify>. How the lines of the statements are classified */
+    bool statisticsEnabled = false; /**< --stats. Write a JSON report with the timings of each stage and the counters of each statement */
+    bool traceEnabled = false; /**< --trace. Write a Chrome trace event file with timed spans for each statement and page */
+    bool cacheEnabled = false; /**< --cache. Reuse the results of statements that were already parsed by an earlier run */
+    bool columnar = false; /**< --columnar. Also write the transactions to a columnar binary file next to the CSV file */
+    bool accountFiles = false; /**< --per-account. Also write a CSV file per account */
+    bool combinedFile = true; /**< --no-combined disables it. Write combined_statements.csv. Only with --per-account */
+    bool summary = false; /**< --summary. Also write the totals by account, month and merchant */
+    bool deduplication = false; /**< --dedup. Drop transactions that an earlier statement already had */
+    unsigned int memoryBudget = 0; /**< --memory-budget <MB>. Spill sorted transactions to disk once they take up more memory than this. 0 keeps everything in memory */
+    bool watch = false; /**< --watch. Keep running after the first conversion and convert new statements as they show up */
+    bool serve = false; /**< --serve. Convert the statements named on stdin one at a time and write their transactions to stdout, instead of converting statements_pdf */
+    unsigned int pollInterval = 2000; /**< --poll-interval <ms>. How often the statements directory is checked in watch mode, if file notifications aren't available */
+
+    /**
+     * @brief Parses the command line arguments.
+     *
+     * @param int The argument count from main().
+     * @param char** The arguments from main().
+     *
+     * @return The parsed options. Anything that wasn't passed keeps its default value.
+     */
+    static Options parse(const int, char**);
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file pdf_loader.h
+ * @brief Header file for the PdfLoader class.
+ */
+#ifndef PDF_LOADER_H
+#define PDF_LOADER_H
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class PdfLoader
+ * @brief Reads PDF statements into memory so Poppler can parse them from there.
+ * 
+ * Each statement is read with a single large read into a buffer that the caller keeps and reuses, instead of leaving the
+ * reads to Poppler. With prefetching enabled, a background thread reads the statements in order, ahead of the ones that
+ * are being parsed, so waiting on storage overlaps with parsing.
+ */
+class PdfLoader {
+public:
+    /**
+     * @brief Constructor. Starts the prefetch thread if prefetching is enabled.
+     * 
+     * @param std::vector<std::string> The statements that will be loaded, in order. Must outlive the loader.
+     * @param size_t The maximum amount of statements that are read ahead and kept in memory. 0 disables prefetching.
+     */
+    PdfLoader(const std::vector<std::string>&, const size_t);
+
+    /**
+     * @brief Destructor. Stops and joins the prefetch thread.
+     */
+    ~PdfLoader();
+
+    PdfLoader(const PdfLoader&) = delete;
+    PdfLoader& operator=(const PdfLoader&) = delete;
+
+    /**
+     * @brief Loads a statement into a buffer. Can be called from multiple threads at once, with different indices.
+     * 
+     * @param size_t The index of the statement in the list passed to the constructor. Each index can be loaded once.
+     * @param std::vector<char> The buffer to load the statement into. Its old contents are lost, but its memory is reused.
+     * Throws an Exception if the statement can't be read.
+     */
+    void load(const size_t, std::vector<char>&);
+
+    /**
+     * @brief Reads a whole file into a buffer.
+     * 
+     * @param std::string The path to the file.
+     * @param std::vector<char> The buffer. It is resized to the size of the file. Throws an Exception if the file can't be read.
+     */
+    static void readFile(const std::string&, std::vector<char>&);
+private:
+    /**
+     * @struct Slot
+     * @brief A statement that was read by the prefetch thread.
+     */
+    struct Slot {
+        std::vector<char> data;
+        std::exception_ptr error; /**< Set if reading the statement failed */
+        bool ready = false;
+    };
+
+    /**
+     * @brief Reads the statements in order, staying at most prefetchCount statements ahead of the ones that were loaded.
+     */
+    void prefetchLoop();
+
+    const std::vector<std::string>& files;
+    const size_t prefetchCount;
+    std::vector<Slot> slots;
+    std::vector<std::vector<char>> freeBuffers; /**< Buffers handed back by load(), reused for the next reads */
+    size_t readyCount = 0; /**< Statements that were read but not loaded yet */
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable slotReady;
+    std::condition_variable slotTaken;
+    std::thread prefetchThread;
+};
+
+#endif
@@ -5,39 +5,84 @@
 #ifndef PDF_PROCESSOR_H
 #define PDF_PROCESSOR_H
 
+#include <chrono>
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
 #include "constants.h"
 #include "transaction.h"
+#include "transaction_store.h"
+#include "statement_result.h"
+#include "thread_pool.h"
+#include "line_classifier.h"
+#include "statement_cache.h"
+#include "statistics.h"
+#include "text_region.h"
+#include "report_writer.h"
+#include "transaction_index.h"
+#include "external_merge.h"
+#include "csv_writer.h"
+#include "columnar_writer.h"
+#include "transaction_summary.h"
+#include "name_interner.h"
+#include "trace.h"
 
 /**
  * @class PdfProcessor
  * @brief This class is responsible for processing PDF bank statements and converting them to a CSV file.
+ * 
+ * It can also be used as a library. convertStatement() and convertFile() parse a single statement and return its
+ * transactions without writing anything, and can be called from multiple threads at once. The worker threads are kept
+ * between calls, so a long-lived PdfProcessor only pays for starting up once.
  */
 class PdfProcessor  {
 public:
     /**
-     * @brief Default constructor.
+     * @brief Constructor.
      * 
-     * Initializes the std::ofstream objects that are used to create the final output.
+     * Nothing is created in the output directory until something is written there, ie. by gatherPdfFiles().
+     * 
+     * @param std::string The directory that the CSV file, the reports, the cache and the spill files go into.
      */
-    PdfProcessor() : skippedFiles("./" + constants::OUTPUT_DIRECTORY + "/" + constants::SKIPPED_FILES_FILE_NAME), skippedLines("./" + constants::OUTPUT_DIRECTORY + "/" + constants::SKIPPED_LINES_FILE_NAME) {};
+    explicit PdfProcessor(const std::string = "./" + constants::OUTPUT_DIRECTORY);
 
     /**
      * @brief Helper function to remove leading and trailing whitespace (including newlines).
      * 
-     * @param std::string The string to trim.
+     * @param std::string_view The string to trim.
      * 
-     * @return The trimmed string.
+     * @return The trimmed string. It points into the string that was passed in.
      */
-    std::string trim(const std::string);
+    std::string_view trim(const std::string_view);
 
     /**
-     * @brief Goes through the directory that holds the PDF statements and adds them to a list. It only adds files that match a certain pattern.
+     * @brief Checks if a file name matches constants::regex::PDF_FILE_NAME, ie. "102324 WellsFargo.pdf".
      * 
-     * @param std::string The path to the directory that contains the PDF statements.
+     * @param std::string_view The file name, without the directory.
+     * 
+     * @return Whether or not it is the name of a statement.
      */
-    void gatherPdfFiles(const std::string);
+    static bool isPdfFileName(const std::string_view);
+
+    /**
+     * @brief Checks if a file name matches constants::regex::PDF_FILE_NAME and takes the date of the statement from it.
+     * 
+     * @param std::string_view The file name, without the directory. ie. "102324 WellsFargo.pdf".
+     * @param uint32_t Set to the date in the file name, in the form YYYYMMDD like Date::getKey(). ie. 20241023.
+     * 
+     * @return Whether or not it is the name of a statement. The date is only set if it is.
+     */
+    static bool parsePdfFileName(const std::string_view, uint32_t&);
+
+    /**
+     * @brief Goes through the directories that hold the PDF statements and adds them to a list, ordered by the date in
+     * their file names. It only adds files that match a certain pattern.
+     * 
+     * @param std::vector<std::string> The paths to the directories that contain the PDF statements.
+     */
+    void gatherPdfFiles(const std::vector<std::string>&);
 
     /**
      * @brief Goes through the gathered PDF statements, extracts the transaction data, and saves it internally.
@@ -47,27 +92,200 @@ public:
     void processPdfs(const std::string);
 
     /**
-     * @brief Utility function that closes the "Skipped Files" file.
+     * @brief Processes statements that showed up after processPdfs(), and merges their transactions into the sorted ones.
+     * 
+     * Their skipped lines and any files that don't match the file name pattern are added to the end of the reports, so the
+     * reports must already be closed. sortTransactions() must have been called already.
+     * 
+     * @param std::vector<std::string> The paths to the new files. Files that were processed before are ignored.
+     */
+    void processNewPdfs(const std::vector<std::string>&);
+
+    /**
+     * @brief Extracts the transaction data and skipped lines from a single PDF statement.
+     * 
+     * Doesn't touch any shared state, so different statements can be processed on different threads at the same time.
+     * If the cache is enabled, statements that were already parsed by an earlier run are loaded from the cache instead.
+     * 
+     * @param std::string The path to the PDF statement.
+     * @param std::vector<char> The contents of the PDF statement.
+     * @param StatementResult Where the extracted data is saved.
+     * @param ThreadPool The pool used to extract pages concurrently, if page threads are enabled.
+     */
+    void processPdf(const std::string&, const std::vector<char>&, StatementResult&, ThreadPool&);
+
+    /**
+     * @brief Parses a single statement that is already in memory, with the current settings, and returns what was in it.
+     * 
+     * Nothing is written, except to the cache if it is enabled, and nothing is kept. Can be called from multiple threads at once.
+     * Throws an Exception if the statement can't be parsed, or its name doesn't match the file name pattern.
+     * 
+     * @param std::string The name or path of the statement, ie. "011524 WellsFargo.pdf". The date of the statement is taken from it.
+     * @param std::vector<char> The contents of the statement.
+     * 
+     * @return The transactions of the statement, sorted by date, and its skipped lines.
+     */
+    StatementResult convertStatement(const std::string&, const std::vector<char>&);
+
+    /**
+     * @brief Reads a single statement and parses it with convertStatement().
+     * 
+     * @param std::string The path to the statement. Its file name has to match the file name pattern.
+     * 
+     * @return The transactions of the statement, sorted by date, and its skipped lines.
+     */
+    StatementResult convertFile(const std::string&);
+
+    /**
+     * @brief Setter for the number of threads used to process the PDF statements.
+     * 
+     * @param unsigned int The number of threads. 1 processes the statements one at a time. Must not be changed while
+     * statements are being processed.
+     */
+    void setThreadCount(const unsigned int);
+
+    /**
+     * @brief Setter for the number of threads that the pages of a single statement are split across.
+     * 
+     * @param unsigned int The number of threads. 1 processes the pages of a statement one at a time.
+     */
+    void setPageThreadCount(const unsigned int);
+
+    /**
+     * @brief Setter for how the lines of the statements are classified.
+     * 
+     * @param ClassifierMode The classifier to use.
+     */
+    void setClassifierMode(const ClassifierMode);
+
+    /**
+     * @brief Turns the statement cache in constants::OUTPUT_DIRECTORY on or off.
+     * 
+     * @param bool Whether or not to use the cache.
+     */
+    void setCacheEnabled(const bool);
+
+    /**
+     * @brief Setter for whether or not transactions that an earlier statement already had are dropped, ie. from statements
+     * that were downloaded twice. See TransactionIndex for when two transactions are the same.
+     * 
+     * @param bool Whether or not to drop them. Disabled by default.
+     */
+    void setDeduplication(const bool);
+
+    /**
+     * @brief Setter for how much memory the transactions can take up before they are sorted and spilled to disk.
+     * 
+     * With a budget, the transactions are written to spill files in the output directory whenever they go over it, and
+     * generateCsvFile() merges the spill files, so memory use doesn't grow with the number of statements. The output is
+     * the same as without a budget. processNewPdfs() can't be used with a budget.
+     * 
+     * @param size_t The budget, in bytes. 0, the default, keeps every transaction in memory.
+     */
+    void setMemoryBudget(const size_t);
+
+    /**
+     * @brief Setter for whether or not generateCsvFile() and updateCsvFile() also write the transactions to a columnar
+     * binary file next to the CSV file. It has the CSV file's name, with constants::COLUMNAR_FILE_EXTENSION instead of
+     * its extension. See ColumnarWriter for the layout. ColumnarWriter keeps every column in memory until the file is
+     * closed, so the memory budget doesn't cover it.
+     * 
+     * @param bool Whether or not to write it. Disabled by default.
+     */
+    void setColumnarEnabled(const bool);
+
+    /**
+     * @brief Setter for whether or not gatherPdfFiles() also looks through the subdirectories of its directories.
+     * 
+     * @param bool Whether or not to look through them. Disabled by default.
+     */
+    void setRecursive(const bool);
+
+    /**
+     * @brief Setter for whether or not generateCsvFile() and updateCsvFile() also write a CSV file per account, named
+     * after its last four, to constants::ACCOUNT_DIRECTORY in the output directory. Each one has the rows of the combined
+     * file for that account, in the same order. Can't be used with a memory budget.
+     * 
+     * @param bool Whether or not to write them. Disabled by default.
+     */
+    void setAccountFilesEnabled(const bool);
+
+    /**
+     * @brief Setter for whether or not generateCsvFile() and updateCsvFile() write the combined CSV file. The columnar
+     * file, the summary and the account files are still written if they are enabled. Can't be turned off with a memory
+     * budget.
+     * 
+     * @param bool Whether or not to write it. Enabled by default.
+     */
+    void setCombinedFileEnabled(const bool);
+
+    /**
+     * @brief Setter for whether or not generateCsvFile() and updateCsvFile() also write constants::SUMMARY_FILE_NAME,
+     * with the totals by account, month and merchant. See TransactionSummary. They are added up while the CSV file is
+     * written, so the transactions aren't gone through twice.
+     * 
+     * @param bool Whether or not to write it. Disabled by default.
+     */
+    void setSummaryEnabled(const bool);
+
+    /**
+     * @brief Setter for the amount of statements that are read into memory ahead of the ones being parsed.
+     * 
+     * @param unsigned int The amount of statements. 0 disables prefetching, which is the default.
+     */
+    void setPrefetchCount(const unsigned int);
+
+    /**
+     * @brief Setter for whether or not pages that can't contribute anything are skipped without classifying their lines.
+     * 
+     * @param bool Whether or not pages are pruned. Enabled by default. It never changes the output.
+     */
+    void setPagePruning(const bool);
+
+    /**
+     * @brief Setter for whether or not the rest of a statement is ignored after constants::regex::TRANSACTION_SECTION_END.
+     * 
+     * @param bool Whether or not to stop there. Disabled by default, since possibly relevant lines after it are no longer
+     * written to the skipped lines file.
+     */
+    void setStopAtSectionEnd(const bool);
+
+    /**
+     * @brief Setter for the part of each page that text is extracted from.
+     * 
+     * @param TextRegion The region. An empty region, the default, extracts the whole page.
+     */
+    void setTextRegion(const TextRegion&);
+
+    /**
+     * @brief Setter for whether or not timings and counters are collected for writeStatistics().
+     * 
+     * @param bool Whether or not statistics are collected. Disabled by default.
+     */
+    void setStatisticsEnabled(const bool);
+
+    /**
+     * @brief Utility function that closes the "Skipped Files" file. Waits for everything queued for it to be written.
      */
     void closeSkippedFilesFile();
 
     /**
-     * @brief Utility function that closes the "Skipped Lines" file.
+     * @brief Utility function that closes the "Skipped Lines" file. Waits for everything queued for it to be written.
      */    
     void closeSkippedLinesFile();
 
     /**
-     * @brief Populates a Transaction object with the provided arguments.
+     * @brief Populates a Transaction object from a line that was classified as a transaction.
      * 
      * @param Transaction The Transaction object to be populated.
-     * @param std::string The line from the statement that has the transaction information.
+     * @param std::string_view The line from the statement that has the transaction information.
+     * @param LineMatch The kind of transaction and the positions of its fields in the line.
      * @param int The year of the statement. NOT the year of the transaction.
      * @param bool Whether or not the transaction was part of a January statement.
      * @param std::string The last four digits of the account.
-     * @param bool Whether or not the transaction is part of a statement that uses the old format.
-     * @param bool Whether or not the transaction is an interest charge.
+     * @param TransactionStore The store that the transaction belongs to. The name is saved in its memory.
      */
-    void generateTransaction(Transaction*, std::string, const int, const bool, const std::string, const bool, const bool);
+    void generateTransaction(Transaction*, const std::string_view, const LineMatch&, const int, const bool, const std::string&, TransactionStore&);
 
     /**
      * @brief Sorts the internally stored transactions.
@@ -79,15 +297,259 @@ public:
      */
     void generateCsvFile(const std::string);
 
+    /**
+     * @brief Brings the CSV file from generateCsvFile() up to date after processNewPdfs(). New transactions are appended
+     * when they all come after the ones already in the file, otherwise the file is generated again.
+     * 
+     * @param std::string The name of the CSV file. It must be the same one that was passed to generateCsvFile().
+     */
+    void updateCsvFile(const std::string);
+
     /**
      * @brief Utility function to print all of the transaction to the console.
      */
     void printAllTransactions();
+
+    /**
+     * @brief Getter for the internally stored transactions.
+     * 
+     * @return The transactions that sortTransactions() and generateCsvFile() work on.
+     */
+    TransactionStore& getTransactions();
+
+    /**
+     * @brief Writes the collected timings and counters as a JSON report.
+     * 
+     * @param std::string The name of the report. It is put into the output directory.
+     */
+    void writeStatistics(const std::string);
+
+    /**
+     * @brief Turns the trace spans for writeTrace() on or off. Spans cover the loading of each statement, the extraction
+     * and classification of each of its pages, the generation of its transactions, and the sorting and CSV generation.
+     * 
+     * @param bool Whether or not spans are recorded. Disabled by default, which skips them at the cost of a branch each.
+     */
+    void setTraceEnabled(const bool);
+
+    /**
+     * @brief Writes the recorded spans as a Chrome trace event JSON file. Does nothing if tracing is disabled.
+     * 
+     * @param std::string The name of the file. It is put into the output directory.
+     */
+    void writeTrace(const std::string);
 private:
-    std::vector<std::string> pdfFiles; /**< Container to hold a list of PDF file names */
-    std::ofstream skippedFiles; /**< Any files that were skipped during the file gathering process */
-    std::ofstream skippedLines; /**< Any lines in the PDF statements that were skipped during processing */
-    std::vector<Transaction*> transactions; /**< Container to hold all of the transaction data */
+    /**
+     * @brief A line of a statement together with everything the patterns found in it.
+     * 
+     * Classifying a line doesn't depend on any other line, so pages can be classified concurrently.
+     */
+    struct ClassifiedLine {
+        std::string_view text; /**< Points into the text of the ClassifiedPage it belongs to */
+        bool isLastFour = false; /**< Matches constants::regex::LAST_FOUR */
+        bool isTitle = false; /**< Matches constants::regex::TRANSACTION_SECTION_TITLE */
+        LineMatch match;
+    };
+
+    /**
+     * @brief The text of a page and its classified lines. The text is kept so the lines can point into it.
+     */
+    struct ClassifiedPage {
+        std::vector<char> text;
+        std::vector<ClassifiedLine> lines;
+        size_t prunedLines = 0; /**< The number of lines of the page if it was pruned, in which case it has no classified lines */
+    };
+
+    /**
+     * @brief The state that is carried from one line of a statement to the next.
+     */
+    struct StatementState {
+        int year = 0; /**< The year of the statement */
+        bool isJanuaryStatement = false;
+        size_t transactionTitleCount = 0; /**< Count the number of times the transaction title is seen because we want to skip the title that's in the header of the statement */
+        bool lastFourFound = false;
+        std::string lastFour;
+        bool sectionEnded = false; /**< Set once constants::regex::TRANSACTION_SECTION_END is seen, if stopping there is enabled */
+    };
+
+    /**
+     * @brief Processes statements across the worker threads and adds their transactions to the internal ones, one run per statement.
+     * 
+     * @param std::vector<std::string> The paths to the statements.
+     * @param ReportWriter Where the skipped lines are written, in file order.
+     */
+    void processFiles(const std::vector<std::string>&, ReportWriter&);
+
+    /**
+     * @brief Drops the transactions from a position on that are already in the internal transactions before the position.
+     * 
+     * @param size_t The first transaction of the statement that was just added. The ones before it are already deduplicated.
+     * 
+     * @return The number of transactions that were dropped.
+     */
+    size_t deduplicate(const size_t);
+
+    /**
+     * @brief Sorts the internal transactions, writes them to a spill file and frees them.
+     */
+    void spillTransactions();
+
+    /**
+     * @brief Writes the spilled transactions and the ones in memory to the CSV file, merged in sorted order. Called by
+     * generateCsvFile() when transactions were spilled.
+     * 
+     * @param CsvWriter The CSV file. It is closed afterwards.
+     * @param ColumnarWriter The columnar file, which gets the same transactions and is closed afterwards. Can be null.
+     */
+    void mergeSpilledTransactions(CsvWriter&, ColumnarWriter*);
+
+    /**
+     * @brief Writes a range of the internal transactions to the CSV file, and adds them to the summary if it is enabled.
+     * The rows are formatted on the thread pool when there are enough of them.
+     * 
+     * @param CsvWriter The CSV file.
+     * @param size_t The position of the first transaction to write.
+     * @param size_t The position after the last transaction to write.
+     */
+    void writeCsvRows(CsvWriter&, const size_t, const size_t);
+
+    /**
+     * @brief Writes the internal transactions to a CSV file per account, at the same time on the thread pool.
+     */
+    void generateAccountFiles();
+
+    /**
+     * @brief Comes up with the file name of an account's CSV file.
+     * 
+     * @param std::string_view The last four of the account.
+     * 
+     * @return The file name, ie. "1234.csv".
+     */
+    static std::string getAccountFileName(const std::string_view);
+
+    /**
+     * @brief Writes the internal transactions to the columnar file that goes with a CSV file.
+     * 
+     * @param std::string The name of the CSV file.
+     */
+    void generateColumnarFile(const std::string&);
+
+    /**
+     * @brief Comes up with the path of the columnar file that goes with a CSV file.
+     * 
+     * @param std::string The name of the CSV file.
+     * 
+     * @return The path, inside the output directory.
+     */
+    std::string getColumnarPath(const std::string&) const;
+
+    /**
+     * @brief Writes the summary of the transactions in the CSV file, if it is enabled.
+     */
+    void writeSummary();
+
+    /**
+     * @brief Adds how many of a page's lines are of each kind to its classification span.
+     * 
+     * @param TraceSpan The span.
+     * @param std::vector<ClassifiedLine> The classified lines of the page.
+     */
+    static void setKindCounters(TraceSpan&, const std::vector<ClassifiedLine>&);
+
+    /**
+     * @brief Parses a single PDF statement with Poppler. Called by processPdf() when the statement isn't cached.
+     * 
+     * @param std::string The path to the PDF statement.
+     * @param std::vector<char> The contents of the PDF statement. Poppler reads the document from here.
+     * @param StatementResult Where the extracted data is saved.
+     * @param ThreadPool The pool used to extract pages concurrently, if page threads are enabled.
+     */
+    void parsePdf(const std::string&, const std::vector<char>&, StatementResult&, ThreadPool&);
+
+    /**
+     * @brief Describes the settings that change how statements are parsed. Used in the cache key.
+     * 
+     * @return The description. Empty with the default settings.
+     */
+    std::string getParseSettings() const;
+
+    /**
+     * @brief Checks if a page can be skipped because none of its lines could be saved or change the statement state.
+     * 
+     * @param StatementState The state of the statement before the page, or nullptr if it isn't known yet.
+     * @param std::string_view The text of the page.
+     * 
+     * @return Whether or not the page can be skipped. Always false if page pruning is disabled.
+     */
+    bool canSkipPage(const StatementState*, const std::string_view) const;
+
+    /**
+     * @brief Runs every pattern on a line.
+     * 
+     * @param std::string_view The line to classify.
+     * 
+     * @return The line along with what it matched.
+     */
+    ClassifiedLine classifyLine(const std::string_view);
+
+    /**
+     * @brief Moves the statement state forward by one line and saves the line to the result if needed.
+     * 
+     * Lines need to be passed in the order they appear in the statement.
+     * 
+     * @param StatementState The state of the statement so far.
+     * @param std::string_view The line.
+     * @param ClassifiedLine The precomputed pattern results for the line, or nullptr to run the patterns as needed.
+     * @param StatementResult Where transactions and skipped lines are saved.
+     */
+    void processLine(StatementState&, const std::string_view, const ClassifiedLine*, StatementResult&);
+
+    /**
+     * @brief Returns where a ScopedTimer should add its time.
+     * 
+     * @param std::chrono::nanoseconds The duration to add the time to.
+     * 
+     * @return The duration, or nullptr if statistics are disabled.
+     */
+    std::chrono::nanoseconds* getTimer(std::chrono::nanoseconds&) const;
+
+    /**
+     * @brief Returns the worker threads, starting them the first time. They are kept until the thread count changes.
+     * 
+     * @return The pool.
+     */
+    ThreadPool& getPool();
+
+    std::string outputDirectory; /**< Where everything is written */
+    std::vector<std::string> pdfFiles; /**< The paths of the PDF statements. gatherPdfFiles() orders them by statement date */
+    ReportWriter skippedFiles; /**< Any files that were skipped during the file gathering process */
+    ReportWriter skippedLines; /**< Any lines in the PDF statements that were skipped during processing */
+    TransactionStore transactions; /**< Container to hold all of the transaction data */
+    size_t csvRowCount = 0; /**< The number of transactions in the last CSV file that was generated. 0 if it just says "None" */
+    size_t unchangedCount = 0; /**< The number of transactions at the front that haven't moved since the CSV file was generated */
+    unsigned int threadCount = ThreadPool::defaultThreadCount(); /**< The number of threads used to process the PDF statements */
+    std::unique_ptr<ThreadPool> pool; /**< Started by getPool() */
+    std::mutex poolMutex;
+    unsigned int pageThreadCount = 1; /**< The number of threads the pages of a single statement are split across */
+    unsigned int prefetchCount = 0; /**< The number of statements read ahead of the ones being parsed */
+    ClassifierMode classifierMode = ClassifierMode::Scanner; /**< How the lines of the statements are classified */
+    std::unique_ptr<StatementCache> cache; /**< The cache of parsed statements. nullptr if the cache is disabled */
+    bool deduplication = false; /**< Drop transactions that an earlier statement already had */
+    TransactionIndex transactionIndex; /**< The positions of the deduplicated transactions. Cleared whenever they are sorted */
+    size_t memoryBudget = 0; /**< The memory the transactions can take up before they are spilled. 0 if there is no budget */
+    bool columnarEnabled = false; /**< Write a columnar file along with the CSV file */
+    bool recursive = false; /**< Look for statements in subdirectories too */
+    bool accountFilesEnabled = false; /**< Write a CSV file per account */
+    bool combinedFileEnabled = true; /**< Write the combined CSV file */
+    bool summaryEnabled = false; /**< Write a summary of the CSV file */
+    TransactionSummary summary; /**< The totals of the transactions in the CSV file */
+    std::unique_ptr<ExternalMerge> externalMerge; /**< The spilled transactions. nullptr if there is no budget */
+    bool pagePruning = true; /**< Skip pages that can't contribute anything */
+    bool stopAtSectionEnd = false; /**< Ignore the rest of a statement after constants::regex::TRANSACTION_SECTION_END */
+    TextRegion textRegion; /**< The part of each page that text is extracted from */
+    bool statisticsEnabled = false;
+    std::unique_ptr<Tracer> tracer; /**< Records the trace spans. Null if tracing is disabled */
+    Statistics statistics; /**< The timings and counters of the run so far */
 };
 
 #endif
\ No newline at end of file
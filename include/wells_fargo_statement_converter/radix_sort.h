@@ -0,0 +1,33 @@
+/**
+ * @file radix_sort.h
+ * @brief Header file for radix sort.
+ */
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <vector>
+#include "transaction.h"
+
+/**
+ * @class RadixSort
+ * @brief Implements a stable least-significant-digit radix sort of transactions by date.
+ */
+class RadixSort {
+public:
+    /**
+     * @brief Sorts the transactions chronologically by Date::getKey(). Transactions with the same date keep their order.
+     * 
+     * @param std::vector<Transaction> The vector to sort.
+     */
+    static void sort(std::vector<Transaction>&);
+
+    /**
+     * @brief Sorts part of a vector of transactions chronologically by Date::getKey(). Transactions with the same date keep their order.
+     * 
+     * @param std::vector<Transaction>::iterator The first transaction to sort.
+     * @param std::vector<Transaction>::iterator One past the last transaction to sort.
+     */
+    static void sort(const std::vector<Transaction>::iterator, const std::vector<Transaction>::iterator);
+};
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file report_writer.h
+ * @brief Header file for the ReportWriter class.
+ */
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ReportWriter
+ * @brief Writes a text report, like the skipped lines file, on a background thread.
+ * 
+ * Text is handed over in whole batches, ie. all of the skipped lines of a statement, so callers only take the lock once
+ * per batch. The background thread drains every batch that is waiting in one go, the same way RK_Logger's log thread
+ * drains its queue. Batches are written in the order they were passed to write().
+ */
+class ReportWriter {
+public:
+    /**
+     * @brief Constructor. The report isn't opened until open() or write() is called, and the background thread isn't
+     * started until the first write(), so a report that is never used costs nothing.
+     * 
+     * @param std::string The path to the report.
+     * @param bool Whether to add to the end of the report instead of overwriting it.
+     */
+    ReportWriter(const std::string&, const bool append = false);
+
+    /**
+     * @brief Destructor. Writes anything that is still waiting and closes the report.
+     */
+    ~ReportWriter();
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    /**
+     * @brief Opens the report, unless it is already open. Nothing is written to a report that couldn't be opened.
+     * 
+     * @return Whether or not the report is open.
+     */
+    bool open();
+
+    /**
+     * @brief Queues text to be written to the report. Can be called from multiple threads at once.
+     * 
+     * @param std::string The text. It is moved into the queue, so nothing is copied.
+     */
+    void write(std::string);
+
+    /**
+     * @brief Waits for everything that was queued to be written, then stops the background thread and closes the report.
+     * Anything written afterwards is dropped.
+     */
+    void close();
+private:
+    /**
+     * @brief Waits for batches and writes them until the report is closed.
+     */
+    void writeLoop();
+
+    std::string path;
+    std::ios::openmode mode;
+    std::ofstream file;
+    std::vector<std::string> pending; /**< Batches waiting to be written, in order */
+    bool closing = false;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable batchReady;
+    std::thread writeThread;
+};
+
+#endif
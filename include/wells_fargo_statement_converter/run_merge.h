@@ -0,0 +1,27 @@
+/**
+ * @file run_merge.h
+ * @brief Header file for the run merge sort.
+ */
+#ifndef RUN_MERGE_H
+#define RUN_MERGE_H
+
+#include <vector>
+#include "transaction.h"
+
+/**
+ * @class RunMerge
+ * @brief Sorts transactions by date by merging runs that are each already (mostly) sorted.
+ */
+class RunMerge {
+public:
+    /**
+     * @brief Sorts the transactions chronologically by Date::getKey(). Transactions with the same date keep their order.
+     * 
+     * @param std::vector<Transaction> The vector to sort.
+     * @param std::vector<size_t> The index of the first transaction of each run, in ascending order. If it is empty, all
+     * of the transactions are a single run.
+     */
+    static void sort(std::vector<Transaction>&, const std::vector<size_t>&);
+};
+
+#endif
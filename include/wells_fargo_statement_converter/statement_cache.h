@@ -0,0 +1,74 @@
+/**
+ * @file statement_cache.h
+ * @brief Header file for the StatementCache class.
+ */
+#ifndef STATEMENT_CACHE_H
+#define STATEMENT_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "statement_result.h"
+
+/**
+ * @class StatementCache
+ * @brief Saves the parsed contents of PDF statements on disk, so statements that haven't changed don't need to be parsed again.
+ * 
+ * Each statement is saved in its own file. The file name is a hash of the statement's bytes, its file name (the statement
+ * date comes from it), and a version tag for the parser and the patterns in constants.h. Changing any of them makes the
+ * old entries unreachable. The directory the statement is in doesn't matter.
+ */
+class StatementCache {
+public:
+    /**
+     * @brief Constructor. Creates the cache directory if it doesn't exist.
+     * 
+     * @param std::string The directory to keep the cache files in.
+     */
+    explicit StatementCache(const std::string&);
+
+    /**
+     * @brief Computes the key of a statement.
+     * 
+     * @param std::string The path to the PDF statement. Only its file name is used.
+     * @param std::vector<char> The contents of the PDF statement.
+     * @param std::string The settings that change how statements are parsed, so results parsed with other settings aren't reused.
+     * 
+     * @return The key.
+     */
+    uint64_t getKey(const std::string&, const std::vector<char>&, const std::string&) const;
+
+    /**
+     * @brief Loads a cached statement.
+     * 
+     * @param uint64_t The key of the statement.
+     * @param StatementResult Where the cached transactions and skipped lines are saved.
+     * 
+     * @return Whether or not the statement was in the cache. The result is left untouched if it wasn't.
+     */
+    bool load(const uint64_t, StatementResult&) const;
+
+    /**
+     * @brief Saves a parsed statement to the cache. Failing to write the cache is logged, but isn't an error.
+     * 
+     * @param uint64_t The key of the statement.
+     * @param StatementResult The parsed statement.
+     */
+    void save(const uint64_t, const StatementResult&) const;
+
+    /**
+     * @brief The version tag of the parser, made from constants::PARSER_VERSION and the patterns in constants.h.
+     * 
+     * @return The version tag.
+     */
+    static uint64_t getVersionTag();
+private:
+    /**
+     * @brief The path of the cache file for a key.
+     */
+    std::string getPath(const uint64_t) const;
+
+    std::string directory;
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file statement_result.h
+ * @brief Header file for the StatementResult struct.
+ */
+#ifndef STATEMENT_RESULT_H
+#define STATEMENT_RESULT_H
+
+#include <exception>
+#include <string>
+#include "statistics.h"
+#include "transaction_store.h"
+
+/**
+ * @struct StatementResult
+ * @brief Holds everything that was extracted from a single PDF statement.
+ *
+ * Each statement is parsed into its own StatementResult so statements can be processed independently of one another,
+ * and then merged in the original file order.
+ */
+struct StatementResult {
+    TransactionStore transactions; /**< The transactions found in the statement, in the order they appeared */
+    std::string skippedLines; /**< The possibly relevant lines that were skipped, one per line */
+    std::exception_ptr error; /**< Set if processing the statement failed */
+    StatementStatistics statistics; /**< The counters are always kept. The timings are only taken with statistics enabled */
+};
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file statistics.h
+ * @brief Header file for the timings and counters that are collected with --stats.
+ */
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct StatementStatistics
+ * @brief The counters and timings of a single PDF statement.
+ * 
+ * The timings add up the time spent by every thread that worked on the statement, so with page threads they can be
+ * larger than the time the statement took.
+ */
+struct StatementStatistics {
+    std::string file;
+    bool cached = false; /**< Loaded from the statement cache. Pages, lines and text bytes aren't known then */
+    size_t pages = 0;
+    size_t prunedPages = 0; /**< Pages that were skipped without classifying their lines */
+    size_t lines = 0; /**< Every line of text that was extracted */
+    size_t matched = 0; /**< Lines that were saved as transactions */
+    size_t skipped = 0; /**< Lines that matched a transaction pattern, but are in the skip list */
+    size_t possiblyRelevant = 0; /**< Lines that didn't match, but look like they have an amount */
+    size_t duplicates = 0; /**< Transactions that were dropped because an earlier statement already had them */
+    size_t textBytes = 0; /**< The size of the extracted text */
+    std::chrono::nanoseconds readTime{}; /**< Reading the statement into memory, or waiting for it to be prefetched */
+    std::chrono::nanoseconds loadTime{}; /**< Loading the document with Poppler, or loading it from the cache */
+    std::chrono::nanoseconds extractTime{}; /**< Creating the pages and extracting their text */
+    std::chrono::nanoseconds classifyTime{}; /**< Running the LineClassifier on the lines */
+    std::chrono::nanoseconds generateTime{}; /**< Turning the matched lines into transactions */
+
+    /**
+     * @brief Adds the counters and timings of another part of the same statement to this one.
+     * 
+     * @param StatementStatistics The other part.
+     */
+    void add(const StatementStatistics&);
+};
+
+/**
+ * @struct Statistics
+ * @brief The counters and timings of a whole run.
+ */
+struct Statistics {
+    unsigned int threadCount = 0;
+    unsigned int pageThreadCount = 0;
+    std::chrono::nanoseconds gatherTime{}; /**< PdfProcessor::gatherPdfFiles() */
+    std::chrono::nanoseconds processTime{}; /**< PdfProcessor::processPdfs(), from start to finish */
+    std::chrono::nanoseconds sortTime{}; /**< PdfProcessor::sortTransactions() */
+    std::chrono::nanoseconds csvTime{}; /**< PdfProcessor::generateCsvFile(), including the merge of the spill files */
+    size_t spillCount = 0; /**< The sorted runs that were written to disk because of the memory budget */
+    std::vector<StatementStatistics> statements; /**< In the order the statements were merged */
+
+    /**
+     * @brief Writes the statistics as a JSON report.
+     * 
+     * @param std::string The path of the report. Throws an Exception if it can't be written.
+     */
+    void writeJson(const std::string&) const;
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Adds the time between its construction and destruction to a duration.
+ */
+class ScopedTimer {
+public:
+    /**
+     * @brief Constructor. Starts the timer.
+     * 
+     * @param std::chrono::nanoseconds* Where the time is added, or nullptr to not time anything.
+     */
+    explicit ScopedTimer(std::chrono::nanoseconds* pTarget) : target(pTarget) {
+        if (target) {
+            startTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (target) {
+            *target += std::chrono::steady_clock::now() - startTime;
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+private:
+    std::chrono::nanoseconds* target;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif
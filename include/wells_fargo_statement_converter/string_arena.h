@@ -0,0 +1,63 @@
+/**
+ * @file string_arena.h
+ * @brief Header file for the StringArena class.
+ */
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class StringArena
+ * @brief Stores many small strings back to back in large blocks of memory.
+ *
+ * Strings are never moved once they are stored, so the std::string_view returned by store() stays valid for as long as
+ * the arena, or whichever arena took over its blocks with append(), is alive.
+ */
+class StringArena {
+public:
+    /**
+     * @brief Copies the string into the arena.
+     *
+     * @param std::string_view The string to copy.
+     *
+     * @return A view of the copy inside the arena.
+     */
+    std::string_view store(const std::string_view);
+
+    /**
+     * @brief Takes over all of the blocks of another arena. Views into the other arena stay valid.
+     *
+     * @param StringArena The arena to take the blocks from. It is left empty.
+     */
+    void append(StringArena&&);
+
+    /**
+     * @brief Frees all of the blocks.
+     */
+    void clear();
+
+    /**
+     * @brief Forgets all of the strings, but keeps the last regular block to store the next ones in. Frees the others.
+     */
+    void reset();
+
+    /**
+     * @brief The amount of memory the arena has allocated.
+     *
+     * @return The size of all of the blocks, in bytes.
+     */
+    size_t getMemoryFootprint() const;
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024; /**< The size of a regular block. Longer strings get a block of their own */
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockUsed = 0; /**< How much of the last block is used */
+    size_t blockCapacity = 0; /**< The size of the last block */
+    size_t allocatedBytes = 0;
+};
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file text_region.h
+ * @brief Header file for the TextRegion struct.
+ */
+#ifndef TEXT_REGION_H
+#define TEXT_REGION_H
+
+/**
+ * @struct TextRegion
+ * @brief The part of a page that text is extracted from, in PDF points (1/72 in) from the top left corner of the page.
+ */
+struct TextRegion {
+    double x = 0;
+    double y = 0;
+    double width = 0;
+    double height = 0;
+
+    /**
+     * @brief An empty region stands for the whole page.
+     * 
+     * @return Whether or not the region is empty.
+     */
+    bool isEmpty() const {
+        return width <= 0 || height <= 0;
+    }
+};
+
+#endif
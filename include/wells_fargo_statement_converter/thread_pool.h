@@ -0,0 +1,100 @@
+/**
+ * @file thread_pool.h
+ * @brief Header file for the ThreadPool class.
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A fixed-size pool of worker threads that runs indexed loops in parallel.
+ *
+ * The thread that calls parallelFor() takes part in the work, so a pool of N threads owns N - 1 workers.
+ * Because the caller always helps, parallelFor() can safely be called from inside a task that is already
+ * running on the pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor. Starts the worker threads.
+     *
+     * @param unsigned int The total number of threads to use, including the calling thread. 0 is treated as 1.
+     */
+    explicit ThreadPool(const unsigned int);
+
+    /**
+     * @brief Destructor. Stops and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Runs the task once for every index in [0, count) and blocks until all of them have finished.
+     *
+     * Every index is run even if some of them throw. Afterwards, the exception thrown by the lowest index is rethrown.
+     *
+     * @param size_t The number of indices to run.
+     * @param std::function<void(size_t)> The task to run for each index.
+     */
+    void parallelFor(const size_t, const std::function<void(size_t)>&);
+
+    /**
+     * @brief Getter for the thread count.
+     *
+     * @return The total number of threads, including the calling thread.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * @brief The thread count to use when none was configured.
+     *
+     * @return std::thread::hardware_concurrency(), or 1 if that is unknown.
+     */
+    static unsigned int defaultThreadCount();
+private:
+    /**
+     * @brief The shared state of a single parallelFor() call.
+     */
+    struct Job {
+        size_t count = 0;
+        const std::function<void(size_t)>* task = nullptr;
+        std::atomic<size_t> next{0}; /**< The next index to hand out */
+        std::atomic<size_t> finished{0}; /**< The number of indices that have completed */
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+        size_t errorIndex = 0;
+    };
+
+    /**
+     * @brief Runs indices of the job until there are none left to hand out.
+     *
+     * @param Job The job to work on.
+     */
+    static void runJob(Job&);
+
+    /**
+     * @brief The loop that each worker thread runs until the pool is destroyed.
+     */
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<Job>> jobs; /**< Jobs that may still have indices to hand out */
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file trace.h
+ * @brief Header file for the trace spans that are collected with --trace.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Tracer
+ * @brief Collects timed spans from every thread and writes them in the Chrome trace event format.
+ *
+ * The file can be opened with chrome://tracing or https://ui.perfetto.dev, which show a timeline per thread. Spans are
+ * only recorded when they end, so the tracer is locked about once per page, never per line.
+ */
+class Tracer {
+public:
+    /**
+     * @struct Event
+     * @brief A span that has ended.
+     */
+    struct Event {
+        const char* name = "";
+        std::string file; /**< The statement or file the span worked on. Can be empty */
+        int page = -1; /**< The index of the page the span worked on, or -1 */
+        uint32_t thread = 0; /**< See getThreadNumber() */
+        std::chrono::steady_clock::time_point startTime;
+        std::chrono::nanoseconds duration{};
+        std::vector<std::pair<const char*, size_t>> counters; /**< Shown with the span, ie. the kinds of lines on a page */
+    };
+
+    /**
+     * @brief Constructor. The times of the spans are relative to when the tracer was made.
+     */
+    Tracer();
+
+    /**
+     * @brief Adds a span that has ended. Can be called from multiple threads at once.
+     *
+     * @param Event The span.
+     */
+    void record(Event&&);
+
+    /**
+     * @brief Writes every span as a Chrome trace event JSON file. Throws an Exception if it can't be written.
+     *
+     * @param std::string The path of the file.
+     */
+    void writeJson(const std::string&) const;
+
+    /**
+     * @brief A small number for the thread that calls it. Threads are numbered in the order they first ask.
+     *
+     * @return The number.
+     */
+    static uint32_t getThreadNumber();
+private:
+    std::chrono::steady_clock::time_point startTime;
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the time between its construction and destruction as a span.
+ *
+ * Without a tracer, it doesn't read the clock or allocate anything, so spans can stay in the code when tracing is off.
+ */
+class TraceSpan {
+public:
+    /**
+     * @brief Constructor. Starts the span.
+     *
+     * @param Tracer* Where the span is recorded, or nullptr to not record anything.
+     * @param char* The name of the span. It must be a string literal, or live as long as the tracer.
+     * @param std::string_view The statement or file the span works on. It must stay valid until the span ends.
+     * @param int The index of the page the span works on, or -1.
+     */
+    TraceSpan(Tracer* pTracer, const char* name, const std::string_view pFile = std::string_view(), const int page = -1)
+        : tracer(pTracer), file(pFile) {
+        if (tracer) {
+            event.name = name;
+            event.page = page;
+            event.startTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (tracer) {
+            event.duration = std::chrono::steady_clock::now() - event.startTime;
+            event.file = std::string(file);
+            event.thread = Tracer::getThreadNumber();
+            tracer->record(std::move(event));
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /**
+     * @brief Adds a number that is shown with the span.
+     *
+     * @param char* The name of the number. It must be a string literal.
+     * @param size_t The number.
+     */
+    void setCounter(const char* name, const size_t value) {
+        if (tracer) {
+            event.counters.emplace_back(name, value);
+        }
+    }
+
+    /**
+     * @brief Whether or not the span is recorded, so work that is only needed for its counters can be skipped.
+     *
+     * @return Whether or not there is a tracer.
+     */
+    bool isEnabled() const {
+        return tracer != nullptr;
+    }
+private:
+    Tracer* tracer;
+    std::string_view file;
+    Tracer::Event event;
+};
+
+#endif
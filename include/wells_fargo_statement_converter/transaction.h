@@ -5,12 +5,18 @@
 #ifndef TRANSACTION_H
 #define TRANSACTION_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include "constants.h"
 #include "date.h"
 
 /**
  * @class Transaction
  * @brief Represents a transaction in a statement.
+ * 
+ * Transactions are small value objects. The last four and the reference number are stored inline, and the name is a view
+ * into a StringArena, which is usually owned by the TransactionStore that holds the transaction.
  */
 class Transaction {
 public:
@@ -22,13 +28,13 @@ public:
     /**
      * @brief Overloaded constructor.
      * 
-     * @param double The currency amount of the transaction.
-     * @param std::string The name of the transaction.
+     * @param int64_t The currency amount of the transaction, in cents.
+     * @param std::string_view The name of the transaction. It isn't copied, so it has to outlive the transaction.
      * @param Date The Date object representing the date of the transaction.
-     * @param std::string The reference number of the transaction.
-     * @param std::string The last four digits of the account number of the transaction.
+     * @param std::string_view The reference number of the transaction.
+     * @param std::string_view The last four digits of the account number of the transaction.
      */
-    Transaction(const double /* amount */, const std::string /* name */, const Date& /* date */, const std::string /* reference num */, const std::string /* last four */);
+    Transaction(const int64_t /* amount in cents */, const std::string_view /* name */, const Date& /* date */, const std::string_view /* reference num */, const std::string_view /* last four */);
 
     /**
      * @brief Accesses the member values that hold the transaction data and combines them all together, separated by commas.
@@ -38,7 +44,16 @@ public:
      * 
      * @return The formatted csv string.
      */
-    std::string getCsvFormat();
+    std::string getCsvFormat() const;
+
+    /**
+     * @brief Same as getCsvFormat(), but appends the formatted csv string to an existing string instead of making a new one.
+     * 
+     * Doesn't allocate as long as the string has enough capacity left.
+     * 
+     * @param std::string The string to append to.
+     */
+    void appendCsvFormat(std::string&) const;
 
     /**
      * @brief Getter for Date.
@@ -47,19 +62,54 @@ public:
      */
     Date& getDate();
 
+    /**
+     * @brief Getter for Date.
+     * 
+     * @return Date object.
+     */
+    const Date& getDate() const;
+
+    /**
+     * @brief Getter for amount.
+     * 
+     * @return The amount, in cents.
+     */
+    int64_t getAmount() const;
+
+    /**
+     * @brief Getter for name.
+     * 
+     * @return The name.
+     */
+    std::string_view getName() const;
+
+    /**
+     * @brief Getter for reference number.
+     * 
+     * @return The reference number.
+     */
+    std::string_view getRefNum() const;
+
+    /**
+     * @brief Getter for last four.
+     * 
+     * @return The last four.
+     */
+    std::string_view getLastFour() const;
+
     /**
      * @brief Setter for amount.
      * 
-     * @param double The amount.
+     * @param int64_t The amount, in cents.
      */
-    void setAmount(const double);
+    void setAmount(const int64_t);
 
     /**
      * @brief Setter for name.
      * 
-     * @param std::string The name.
+     * @param std::string_view The name. It isn't copied, so it has to outlive the transaction. Use TransactionStore::storeName().
      */
-    void setName(const std::string);
+    void setName(const std::string_view);
 
     /**
      * @brief Setter for date.
@@ -71,22 +121,42 @@ public:
     /**
      * @brief Setter for reference number.
      * 
-     * @param std::string The reference number.
+     * @param std::string_view The reference number. Only the first constants::REF_NUM_SIZE characters are kept.
      */
-    void setRefNum(const std::string);
+    void setRefNum(const std::string_view);
 
     /**
      * @brief Setter for last four.
      * 
-     * @param The last four.
+     * @param std::string_view The last four. Only the first constants::LAST_FOUR_SIZE characters are kept.
+     */
+    void setLastFour(const std::string_view);
+
+    /**
+     * @brief Converts an amount from a statement, like "1,234.56", to cents. Commas are skipped.
+     * 
+     * @param std::string_view Digits and commas, followed by a '.' and exactly two digits.
+     * @param int64_t Set to the amount in cents.
+     * 
+     * @return Whether or not the amount was valid and fit into an int64_t.
+     */
+    static bool parseAmount(const std::string_view, int64_t&);
+
+    /**
+     * @brief Formats an amount the way the CSV file shows it, as a charge. ie. 1534 cents becomes "-15.34".
+     * 
+     * @param std::string The string to append to.
+     * @param int64_t The amount in cents.
      */
-    void setLastFour(const std::string);
+    static void appendAmount(std::string&, const int64_t);
 private:
-    double amount; /**< The currency amount */
-    std::string name;
+    int64_t amount = 0; /**< The currency amount, in cents. Kept as an integer so sums are exact */
+    std::string_view name;
     Date date;
-    std::string referenceNum;
-    std::string lastFour;
+    char referenceNum[constants::REF_NUM_SIZE];
+    char lastFour[constants::LAST_FOUR_SIZE];
+    uint8_t referenceNumLength = 0;
+    uint8_t lastFourLength = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file transaction_index.h
+ * @brief Header file for the TransactionIndex class.
+ */
+#ifndef TRANSACTION_INDEX_H
+#define TRANSACTION_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "transaction.h"
+
+/**
+ * @class TransactionIndex
+ * @brief A hash set of transactions, used to find transactions that were already seen in another statement.
+ * 
+ * Two transactions are the same if they have the same last four, reference number, date and amount. Interest charges
+ * don't have a reference number, so for transactions without one the name is compared as well.
+ * 
+ * The index doesn't hold the transactions. It is a flat, open-addressed table of positions in a vector of transactions,
+ * each with part of its hash, so it takes 8 bytes per slot and collisions rarely need to look at the transactions.
+ * The positions have to stay valid, so the index has to be cleared when the transactions are moved, ie. by sorting them.
+ */
+class TransactionIndex {
+public:
+    static constexpr size_t NOT_FOUND = SIZE_MAX; /**< What find() returns when no indexed transaction is the same */
+
+    /**
+     * @brief Adds a transaction to the index, unless an indexed transaction is the same.
+     * 
+     * @param std::vector<Transaction> The transactions that the indexed positions point into.
+     * @param Transaction The transaction to add. It doesn't have to be at its position yet.
+     * @param size_t The position of the transaction in the vector.
+     * 
+     * @return Whether or not it was added. false means it is a duplicate.
+     */
+    bool insert(const std::vector<Transaction>&, const Transaction&, const size_t);
+
+    /**
+     * @brief Looks for an indexed transaction that is the same as a transaction.
+     * 
+     * @param std::vector<Transaction> The transactions that the indexed positions point into.
+     * @param Transaction The transaction to look for.
+     * 
+     * @return The position of the indexed transaction, or NOT_FOUND if there is none.
+     */
+    size_t find(const std::vector<Transaction>&, const Transaction&) const;
+
+    /**
+     * @brief Removes every transaction from the index and frees its memory.
+     */
+    void clear();
+
+    /**
+     * @brief Removes every transaction from the index, but keeps the table if it is small enough to empty quickly.
+     */
+    void reset();
+
+    /**
+     * @brief The number of transactions in the index.
+     * 
+     * @return The number of transactions.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Hashes the parts of a transaction that make it unique.
+     * 
+     * @param Transaction The transaction.
+     * 
+     * @return The hash.
+     */
+    static uint64_t hash(const Transaction&);
+
+    /**
+     * @brief Checks if two transactions are the same, as described above.
+     * 
+     * @param Transaction The first transaction.
+     * @param Transaction The second transaction.
+     * 
+     * @return Whether or not they are the same.
+     */
+    static bool isSame(const Transaction&, const Transaction&);
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX; /**< The position of a slot that is not in use */
+
+    /**
+     * @struct Slot
+     * @brief A position in the table.
+     */
+    struct Slot {
+        uint32_t position = EMPTY;
+        uint32_t tag = 0; /**< The upper half of the hash. The lower half picks the slot */
+    };
+
+    /**
+     * @brief Doubles the size of the table and puts every transaction back into it.
+     * 
+     * @param std::vector<Transaction> The transactions that the indexed positions point into.
+     */
+    void grow(const std::vector<Transaction>&);
+
+    std::vector<Slot> slots; /**< Always a power of 2, so the hash can be masked to pick a slot */
+    size_t count = 0;
+};
+
+#endif
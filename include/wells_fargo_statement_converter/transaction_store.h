@@ -0,0 +1,148 @@
+/**
+ * @file transaction_store.h
+ * @brief Header file for the TransactionStore class.
+ */
+#ifndef TRANSACTION_STORE_H
+#define TRANSACTION_STORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "string_arena.h"
+#include "transaction.h"
+
+/**
+ * @class TransactionStore
+ * @brief Owns a list of transactions, stored contiguously by value, along with the memory for their names.
+ * 
+ * The transactions are grouped into runs. Transactions added with add() belong to the current run, and each store that
+ * is appended with append() becomes a run of its own. Every statement is parsed into its own store, so each statement
+ * ends up as one run, which the sort uses to take advantage of statements already being mostly in date order.
+ */
+class TransactionStore {
+public:
+    typedef std::vector<Transaction>::iterator iterator;
+    typedef std::vector<Transaction>::const_iterator const_iterator;
+
+    /**
+     * @brief Adds a new, empty transaction to the end of the store.
+     * 
+     * @return The new transaction. The reference is only valid until the next transaction is added.
+     */
+    Transaction& add();
+
+    /**
+     * @brief Copies a name into the store's memory so it can be given to Transaction::setName().
+     * 
+     * @param std::string_view The name.
+     * 
+     * @return A view of the copy, which lives as long as the store.
+     */
+    std::string_view storeName(const std::string_view);
+
+    /**
+     * @brief Moves all of the transactions of another store to the end of this one. Names are not copied.
+     * 
+     * @param TransactionStore The store to take the transactions from. It is left empty.
+     */
+    void append(TransactionStore&&);
+
+    /**
+     * @brief Removes transactions from the end of the store. The rest keep their order, and runs that end up empty are removed.
+     * 
+     * @param size_t The first transaction that may be removed. The transactions before it are always kept.
+     * @param Keep Called in order with each transaction from there on, and the index the transaction will have if it is kept.
+     * Returns whether or not to keep it. Every transaction before that index is already in its place.
+     * 
+     * @return The number of transactions that were removed.
+     */
+    template <typename Keep>
+    size_t filter(const size_t, Keep);
+
+    /**
+     * @brief Getter for where each run starts.
+     * 
+     * @return The index of the first transaction of each run, in ascending order. Empty if the store is empty.
+     */
+    const std::vector<size_t>& getRunStarts() const;
+
+    /**
+     * @brief Removes all of the transactions and frees their memory.
+     */
+    void clear();
+
+    /**
+     * @brief Removes all of the transactions, but keeps their memory to add new ones to. See StringArena::reset().
+     */
+    void reset();
+
+    /**
+     * @brief The number of transactions in the store.
+     * 
+     * @return The number of transactions.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Whether or not the store has any transactions.
+     * 
+     * @return true if there are no transactions.
+     */
+    bool empty() const;
+
+    /**
+     * @brief The amount of memory used by the transactions and their names.
+     * 
+     * @return The memory footprint, in bytes.
+     */
+    size_t getMemoryFootprint() const;
+
+    /**
+     * @brief Direct access to the transactions, for algorithms such as sorting.
+     * 
+     * @return The transactions.
+     */
+    std::vector<Transaction>& getTransactions();
+
+    Transaction& operator[](const size_t);
+    const Transaction& operator[](const size_t) const;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+private:
+    std::vector<Transaction> transactions;
+    StringArena names; /**< The memory that the names of the transactions point into */
+    std::vector<size_t> runStarts; /**< The index of the first transaction of each run */
+};
+
+/**
+ * The kept transactions are moved forward over the removed ones, and the runs are moved along with them.
+ */
+template <typename Keep>
+size_t TransactionStore::filter(const size_t first, Keep keep) {
+    size_t run = std::lower_bound(runStarts.begin(), runStarts.end(), first) - runStarts.begin();
+    size_t kept = first;
+    for (size_t i = first; i < transactions.size(); ++i) {
+        while (run < runStarts.size() && runStarts[run] == i) {
+            runStarts[run++] = kept;
+        }
+        if (keep(static_cast<const Transaction&>(transactions[i]), kept)) {
+            if (kept != i) {
+                transactions[kept] = transactions[i];
+            }
+            kept++;
+        }
+    }
+
+    const size_t removed = transactions.size() - kept;
+    transactions.resize(kept);
+    runStarts.erase(std::unique(runStarts.begin(), runStarts.end()), runStarts.end());
+    while (!runStarts.empty() && runStarts.back() >= kept) {
+        runStarts.pop_back();
+    }
+    return removed;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file transaction_summary.h
+ * @brief Header file for the TransactionSummary class.
+ */
+#ifndef TRANSACTION_SUMMARY_H
+#define TRANSACTION_SUMMARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "name_interner.h"
+#include "transaction.h"
+
+/**
+ * @class TransactionSummary
+ * @brief Adds up the transactions by account, by month and by merchant, as they are written to the CSV file.
+ *
+ * The last fours and the names are interned, so each group is an index into a vector of totals and adding a transaction
+ * doesn't compare any strings unless two hashes collide. Months are kept sorted, and transactions usually come in date
+ * order, so they mostly land in the last month.
+ *
+ * The summary is a CSV file with a row per group: "<account|month|merchant>","<group>","<transactions>","<total>". The
+ * totals are formatted like the amounts in the CSV file. Accounts are sorted by last four, months by date and merchants
+ * by name. ie.
+ * "month","04/2023","42","-1234.56"
+ */
+class TransactionSummary {
+public:
+    /**
+     * @brief Adds a transaction to its account, month and merchant.
+     *
+     * @param Transaction The transaction. Its strings don't have to stay valid afterwards.
+     */
+    void add(const Transaction&);
+
+    /**
+     * @brief Writes the summary to a file. Throws an Exception if it can't be written.
+     *
+     * @param std::string The path of the file.
+     */
+    void write(const std::string&) const;
+
+    /**
+     * @brief Removes every transaction from the summary.
+     */
+    void clear();
+private:
+    /**
+     * @struct Total
+     * @brief The transactions of a group.
+     */
+    struct Total {
+        size_t count = 0;
+        int64_t amount = 0; /**< In cents */
+    };
+
+    NameInterner accountNames;
+    std::vector<Total> accounts; /**< Indexed by the number of the last four in accountNames */
+    std::vector<std::pair<uint32_t, Total>> months; /**< Sorted by the month, in the form YYYYMM */
+    NameInterner merchantNames;
+    std::vector<Total> merchants; /**< Indexed by the number of the name in merchantNames */
+};
+
+#endif
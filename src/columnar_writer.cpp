@@ -0,0 +1,110 @@
+/**
+ * @file columnar_writer.cpp
+ * @brief Source file for the ColumnarWriter class.
+ */
+#include <array>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include "wells_fargo_statement_converter/columnar_writer.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+constexpr char MAGIC[8] = {'W', 'F', 'C', 'O', 'L', 'U', 'M', 'N'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t COLUMN_COUNT = 7;
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t) + 2 * sizeof(uint32_t) + COLUMN_COUNT * sizeof(uint64_t);
+
+/**
+ * @brief Rounds a size up to the next multiple of 8.
+ */
+uint64_t align(const uint64_t size) {
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+template <typename T>
+void append(std::string& buffer, const T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+ColumnarWriter::ColumnarWriter(const std::string& pPath) : path(pPath), file(pPath, std::ios::binary | std::ios::trunc) {
+    if (!file) {
+        LOG_ERROR("Couldn't open ", path, "\n");
+        throw Exception("Couldn't open " + path);
+    }
+    nameOffsets.push_back(0);
+}
+
+/**
+ * Reference numbers and last fours shorter than their column are padded with zeros.
+ */
+void ColumnarWriter::write(const Transaction& transaction) {
+    dates.push_back(transaction.getDate().getKey());
+    amounts.push_back(-transaction.getAmount()); // The CSV file shows charges as negative
+
+    std::string lastFour(transaction.getLastFour());
+    lastFour.resize(constants::LAST_FOUR_SIZE, '\0');
+    auto account = accountIndices.find(lastFour);
+    if (account == accountIndices.end()) {
+        if (accountIndices.size() > std::numeric_limits<uint16_t>::max()) {
+            LOG_ERROR("Too many accounts for ", path, "\n");
+            throw Exception("Too many accounts for " + path);
+        }
+        account = accountIndices.emplace(lastFour, static_cast<uint16_t>(accountIndices.size())).first;
+        accountDictionary += lastFour;
+    }
+    accounts.push_back(account->second);
+
+    const std::string_view refNum = transaction.getRefNum();
+    referenceNums.append(refNum.data(), refNum.size());
+    referenceNums.append(constants::REF_NUM_SIZE - refNum.size(), '\0');
+
+    names.append(transaction.getName().data(), transaction.getName().size());
+    nameOffsets.push_back(names.size());
+}
+
+/**
+ * The offsets of the columns are worked out first, so the header and the columns can be written in a single pass.
+ */
+void ColumnarWriter::close() {
+    const std::array<std::pair<const char*, uint64_t>, COLUMN_COUNT> columns = {{
+        {reinterpret_cast<const char*>(dates.data()), dates.size() * sizeof(uint32_t)},
+        {reinterpret_cast<const char*>(amounts.data()), amounts.size() * sizeof(int64_t)},
+        {reinterpret_cast<const char*>(accounts.data()), accounts.size() * sizeof(uint16_t)},
+        {accountDictionary.data(), accountDictionary.size()},
+        {referenceNums.data(), referenceNums.size()},
+        {reinterpret_cast<const char*>(nameOffsets.data()), nameOffsets.size() * sizeof(uint64_t)},
+        {names.data(), names.size()},
+    }};
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    append<uint32_t>(header, COLUMNAR_VERSION);
+    append<uint32_t>(header, BYTE_ORDER_MARK);
+    append<uint64_t>(header, dates.size());
+    append<uint32_t>(header, static_cast<uint32_t>(accountIndices.size()));
+    append<uint32_t>(header, static_cast<uint32_t>(constants::REF_NUM_SIZE));
+    uint64_t offset = align(HEADER_SIZE);
+    for (const auto& column : columns) {
+        append<uint64_t>(header, offset);
+        offset = align(offset + column.second);
+    }
+
+    static const char PADDING[8] = {};
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(PADDING, static_cast<std::streamsize>(align(HEADER_SIZE) - HEADER_SIZE));
+    for (const auto& column : columns) {
+        file.write(column.first, static_cast<std::streamsize>(column.second));
+        file.write(PADDING, static_cast<std::streamsize>(align(column.second) - column.second));
+    }
+
+    file.close();
+    if (!file) {
+        LOG_ERROR("Couldn't write ", path, "\n");
+        throw Exception("Couldn't write " + path);
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file csv_writer.cpp
+ * @brief Source file for the CsvWriter class.
+ */
+#include "wells_fargo_statement_converter/csv_writer.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+/**
+ * The buffer gets some room on top of BUFFER_SIZE, so a row that is added while it is almost full normally still fits
+ * without it having to grow.
+ */
+CsvWriter::CsvWriter(const std::string& pPath, const bool append) : path(pPath), file(pPath, append ? std::ios::app : std::ios::trunc) {
+    if (!file) {
+        LOG_ERROR("Couldn't open ", path, "\n");
+        throw Exception("Couldn't open " + path);
+    }
+    buffer.reserve(BUFFER_SIZE + 4096);
+}
+
+CsvWriter::~CsvWriter() {
+    if (file.is_open()) {
+        flush();
+    }
+}
+
+void CsvWriter::write(const Transaction& transaction) {
+    transaction.appendCsvFormat(buffer);
+    buffer += '\n';
+    if (buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void CsvWriter::write(const std::string_view text) {
+    if (text.size() >= DIRECT_WRITE_SIZE) {
+        flush();
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+    buffer.append(text.data(), text.size());
+    if (buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void CsvWriter::flush() {
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear(); // Keeps the capacity
+}
+
+void CsvWriter::close() {
+    flush();
+    file.close();
+    if (!file) {
+        LOG_ERROR("Couldn't write ", path, "\n");
+        throw Exception("Couldn't write " + path);
+    }
+}
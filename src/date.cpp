@@ -10,7 +10,7 @@ Date::Date(const int pYear, const int pMonth, const int pDay) : year(pYear), mon
 
 Date::Date(const Date& pDate) : year(pDate.year), month(pDate.month), day(pDate.day) {}
 
-std::string Date::getDateString() {
+std::string Date::getDateString() const {
     return "[" + std::to_string(month) + "/" + std::to_string(day) + "/" + std::to_string(year) + "]";
 }
 
@@ -28,27 +28,25 @@ Date& Date::operator=(const Date& other) {
 
 /**
  * Checks if a date is less than or equal to another date. A date is "less than" 
- * another date if it is further in the past. Comparison starts broad, then gets
- * more narrow. For example, it starts with years, if they're the same it'll go to months and so on.
+ * another date if it is further in the past. The packed keys are ordered the same way,
+ * so comparing them compares the years, then the months, then the days.
  */
 bool Date::operator<=(const Date& other) const {
-    if (year != other.year) {
-        return year <= other.year;
-    }
-    if (month != other.month) {
-        return month <= other.month;
-    }
-    return day <= other.day;
+    return getKey() <= other.getKey();
+}
+
+uint32_t Date::getKey() const {
+    return static_cast<uint32_t>(year) * 10000 + static_cast<uint32_t>(month) * 100 + static_cast<uint32_t>(day);
 }
 
-int const Date::getYear() {
+int Date::getYear() const {
     return year;
 }
 
-int const Date::getMonth() {
+int Date::getMonth() const {
     return month;
 }
 
-int const Date::getDay() {
+int Date::getDay() const {
     return day;
 }
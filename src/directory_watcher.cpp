@@ -0,0 +1,134 @@
+/**
+ * @file directory_watcher.cpp
+ * @brief Source file for the DirectoryWatcher class.
+ */
+#include <thread>
+#include "wells_fargo_statement_converter/directory_watcher.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+bool DirectoryWatcher::Changes::empty() const {
+    return added.empty() && modified.empty() && removed.empty();
+}
+
+bool DirectoryWatcher::FileState::operator==(const FileState& other) const {
+    return size == other.size && writeTime == other.writeTime;
+}
+
+DirectoryWatcher::DirectoryWatcher(const std::string& pDirectory, const std::chrono::milliseconds pPollInterval) : directory(pDirectory), pollInterval(pPollInterval) {
+#ifdef __linux__
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd >= 0 && inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ATTRIB) < 0) {
+        ::close(notifyFd);
+        notifyFd = -1;
+    }
+#endif
+    if (notifyFd < 0) {
+        LOG_INFO("Polling ", directory, " for changes every ", pollInterval.count(), " ms\n");
+    }
+    else {
+        LOG_INFO("Watching ", directory, " for changes with inotify\n");
+    }
+    files = list();
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+#ifdef __linux__
+    if (notifyFd >= 0) {
+        ::close(notifyFd);
+    }
+#endif
+}
+
+/**
+ * Once the listing differs from the last one, it is taken again every constants::WATCH_SETTLE_TIME_MS until two listings
+ * in a row are the same. Then the two listings are compared file by file.
+ */
+DirectoryWatcher::Changes DirectoryWatcher::waitForChanges(const std::atomic<bool>& stop) {
+    Changes changes;
+    while (!stop && changes.empty()) {
+        if (!waitForEvent()) {
+            continue;
+        }
+        Listing current = list();
+        if (current == files) {
+            continue;
+        }
+
+        while (!stop) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(constants::WATCH_SETTLE_TIME_MS));
+            Listing settled = list();
+            if (settled == current) {
+                break;
+            }
+            LOG_DEBUG("Files in ", directory, " are still changing\n");
+            current = std::move(settled);
+        }
+        if (stop) {
+            break;
+        }
+
+        for (const auto& [path, state] : current) {
+            const auto old = files.find(path);
+            if (old == files.end()) {
+                changes.added.push_back(path);
+            }
+            else if (!(old->second == state)) {
+                changes.modified.push_back(path);
+            }
+        }
+        for (const auto& entry : files) {
+            if (current.find(entry.first) == current.end()) {
+                changes.removed.push_back(entry.first);
+            }
+        }
+        files = std::move(current);
+    }
+
+    LOG_DEBUG(changes.added.size(), " files were added, ", changes.modified.size(), " changed and ", changes.removed.size(), " removed\n");
+    return changes;
+}
+
+DirectoryWatcher::Listing DirectoryWatcher::list() const {
+    Listing listing;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        std::error_code fileError;
+        if (!it->is_regular_file(fileError)) {
+            continue;
+        }
+        FileState state;
+        state.size = it->file_size(fileError);
+        state.writeTime = it->last_write_time(fileError);
+        if (!fileError) {
+            listing.emplace(it->path().string(), state);
+        }
+    }
+    return listing;
+}
+
+/**
+ * The inotify events themselves are thrown away, since the directory is listed again anyway. They only save listing it
+ * when nothing happened.
+ */
+bool DirectoryWatcher::waitForEvent() {
+#ifdef __linux__
+    if (notifyFd >= 0) {
+        pollfd request = {notifyFd, POLLIN, 0};
+        if (::poll(&request, 1, static_cast<int>(pollInterval.count())) <= 0) {
+            return false; // Timed out, or interrupted by a signal
+        }
+        alignas(inotify_event) char events[4096];
+        while (::read(notifyFd, events, sizeof(events)) > 0) {}
+        return true;
+    }
+#endif
+    std::this_thread::sleep_for(pollInterval);
+    return true;
+}
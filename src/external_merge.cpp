@@ -0,0 +1,309 @@
+/**
+ * @file external_merge.cpp
+ * @brief Source file for the ExternalMerge class.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <queue>
+#include <string_view>
+#include "wells_fargo_statement_converter/external_merge.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/log_level.h"
+#include "wells_fargo_statement_converter/transaction_index.h"
+#include "wells_fargo_statement_converter/transaction_store.h"
+
+namespace {
+
+constexpr size_t BUFFER_SIZE = 256 * 1024; /**< How much of a spill file is written or read at a time */
+
+/**
+ * @brief Writes transactions to a spill file through a buffer.
+ * 
+ * Each transaction is its amount, year, month and day, then its last four, reference number and name, each prefixed
+ * with its length.
+ */
+class RunWriter {
+public:
+    explicit RunWriter(const std::string& pPath) : path(pPath), file(pPath, std::ios::binary | std::ios::trunc) {
+        if (!file) {
+            LOG_ERROR("Couldn't open ", path, "\n");
+            throw Exception("Couldn't open " + path);
+        }
+        buffer.reserve(BUFFER_SIZE + 4096);
+    }
+
+    void write(const Transaction& transaction) {
+        put<int64_t>(transaction.getAmount());
+        put<int32_t>(transaction.getDate().getYear());
+        put<int8_t>(static_cast<int8_t>(transaction.getDate().getMonth()));
+        put<int8_t>(static_cast<int8_t>(transaction.getDate().getDay()));
+        putString<uint8_t>(transaction.getLastFour());
+        putString<uint8_t>(transaction.getRefNum());
+        putString<uint32_t>(transaction.getName());
+        if (buffer.size() >= BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    void close() {
+        flush();
+        file.close();
+        if (!file) {
+            LOG_ERROR("Couldn't write ", path, "\n");
+            throw Exception("Couldn't write " + path);
+        }
+    }
+private:
+    template <typename T>
+    void put(const T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename Length>
+    void putString(const std::string_view str) {
+        put<Length>(static_cast<Length>(str.size()));
+        buffer.append(str.data(), str.size());
+    }
+
+    void flush() {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    std::string path;
+    std::ofstream file;
+    std::string buffer;
+};
+
+/**
+ * @brief Reads back the transactions of a spill file one at a time.
+ */
+class RunReader {
+public:
+    explicit RunReader(const std::string& pPath) : path(pPath), file(pPath, std::ios::binary) {
+        if (!file) {
+            LOG_ERROR("Couldn't open ", path, "\n");
+            throw Exception("Couldn't open " + path);
+        }
+    }
+
+    /**
+     * @brief Reads the next transaction into current.
+     * 
+     * @return false once the file has been read completely. Throws an Exception if the file is cut short.
+     */
+    bool next() {
+        int64_t amount = 0;
+        int32_t year = 0;
+        int8_t month = 0;
+        int8_t day = 0;
+        if (!get(amount)) {
+            return false;
+        }
+        if (!get(year) || !get(month) || !get(day) || !getString<uint8_t>(lastFour) || !getString<uint8_t>(refNum) || !getString<uint32_t>(name)) {
+            LOG_ERROR(path, " is cut short\n");
+            throw Exception(path + " is cut short");
+        }
+        current.setAmount(amount);
+        current.setDate(Date(year, month, day));
+        current.setLastFour(lastFour);
+        current.setRefNum(refNum);
+        current.setName(name);
+        return true;
+    }
+
+    Transaction current;
+private:
+    /**
+     * @brief Makes sure that the buffer holds at least the given amount of unread bytes, reading more of the file if needed.
+     */
+    bool fill(const size_t size) {
+        if (buffer.size() - position >= size) {
+            return true;
+        }
+        buffer.erase(0, position);
+        position = 0;
+        const size_t toRead = std::max(size - buffer.size(), BUFFER_SIZE);
+        const size_t oldSize = buffer.size();
+        buffer.resize(oldSize + toRead);
+        file.read(&buffer[oldSize], static_cast<std::streamsize>(toRead));
+        buffer.resize(oldSize + static_cast<size_t>(file.gcount()));
+        return buffer.size() >= size;
+    }
+
+    template <typename T>
+    bool get(T& value) {
+        if (!fill(sizeof(T))) {
+            return false;
+        }
+        std::memcpy(&value, buffer.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    template <typename Length>
+    bool getString(std::string& str) {
+        Length size = 0;
+        if (!get(size) || !fill(size)) {
+            return false;
+        }
+        str.assign(buffer.data() + position, size);
+        position += size;
+        return true;
+    }
+
+    std::string path;
+    std::ifstream file;
+    std::string buffer;
+    size_t position = 0;
+    std::string lastFour;
+    std::string refNum;
+    std::string name; /**< current's name points into here */
+};
+
+/**
+ * @brief The next transaction of a run, ordered so that earlier dates, then earlier runs, come out of the heap first.
+ */
+struct RunHead {
+    uint32_t key;
+    size_t run;
+
+    bool operator>(const RunHead& other) const {
+        return key != other.key ? key > other.key : run > other.run;
+    }
+};
+
+} // namespace
+
+ExternalMerge::ExternalMerge(const std::string& pDirectory) : directory(pDirectory) {}
+
+ExternalMerge::~ExternalMerge() {
+    for (const auto& runFile : runFiles) {
+        std::error_code error;
+        std::filesystem::remove(runFile, error);
+    }
+}
+
+void ExternalMerge::spill(const std::vector<Transaction>& run) {
+    const std::string path = nextPath();
+    LOG_INFO("Spilling ", run.size(), " transactions to ", path, "\n");
+    RunWriter writer(path);
+    runFiles.push_back(path);
+    for (const auto& transaction : run) {
+        writer.write(transaction);
+    }
+    writer.close();
+}
+
+size_t ExternalMerge::getRunCount() const {
+    return runFiles.size();
+}
+
+/**
+ * While there are more runs than can be opened at once, consecutive groups of them are merged into new spill files.
+ * Keeping the groups consecutive keeps ties in the same order.
+ */
+size_t ExternalMerge::merge(const std::vector<Transaction>& memoryRun, const bool deduplicate, const std::function<void(const Transaction&)>& sink) {
+    size_t duplicateCount = 0;
+    while (runFiles.size() > MAX_MERGE_WIDTH) {
+        LOG_INFO("Merging ", runFiles.size(), " spill files in groups of ", MAX_MERGE_WIDTH, "\n");
+        std::vector<std::string> mergedFiles;
+        for (size_t begin = 0; begin < runFiles.size(); begin += MAX_MERGE_WIDTH) {
+            const std::vector<std::string> group(runFiles.begin() + begin, runFiles.begin() + std::min(begin + MAX_MERGE_WIDTH, runFiles.size()));
+            const std::string path = nextPath();
+            RunWriter writer(path);
+            mergedFiles.push_back(path);
+            duplicateCount += mergeRuns(group, std::vector<Transaction>(), deduplicate, [&writer](const Transaction& transaction) { writer.write(transaction); });
+            writer.close();
+            for (const auto& runFile : group) {
+                std::filesystem::remove(runFile);
+            }
+        }
+        runFiles.swap(mergedFiles);
+    }
+
+    LOG_INFO("Merging ", runFiles.size(), " spill files and ", memoryRun.size(), " transactions in memory\n");
+    duplicateCount += mergeRuns(runFiles, memoryRun, deduplicate, sink);
+    for (const auto& runFile : runFiles) {
+        std::filesystem::remove(runFile);
+    }
+    runFiles.clear();
+    return duplicateCount;
+}
+
+/**
+ * A min-heap holds the next transaction of each run. The run in memory is the last one, so it loses ties.
+ * 
+ * Duplicates always have the same date, so only the transactions with the date that is being merged need to be indexed.
+ * Their names are copied, since the readers reuse the memory of the names they read.
+ */
+size_t ExternalMerge::mergeRuns(const std::vector<std::string>& files, const std::vector<Transaction>& memoryRun, const bool deduplicate,
+                                const std::function<void(const Transaction&)>& sink) {
+    std::vector<RunReader> readers;
+    readers.reserve(files.size());
+    for (const auto& file : files) {
+        readers.emplace_back(file);
+    }
+
+    const size_t memoryRunIdx = readers.size();
+    size_t memoryPosition = 0;
+    std::priority_queue<RunHead, std::vector<RunHead>, std::greater<RunHead>> heads;
+    const auto advance = [&](const size_t run) {
+        if (run == memoryRunIdx) {
+            if (memoryPosition < memoryRun.size()) {
+                heads.push(RunHead{memoryRun[memoryPosition].getDate().getKey(), run});
+            }
+        }
+        else if (readers[run].next()) {
+            heads.push(RunHead{readers[run].current.getDate().getKey(), run});
+        }
+    };
+    for (size_t run = 0; run <= memoryRunIdx; ++run) {
+        advance(run);
+    }
+
+    TransactionStore sameDate;
+    std::vector<size_t> sameDateRuns; // The run that each of them came from
+    TransactionIndex sameDateIndex;
+    const auto isDuplicate = [&](const Transaction& transaction, const size_t run) {
+        if (!sameDate.empty() && sameDate[0].getDate().getKey() != transaction.getDate().getKey()) {
+            // Keeps the arena block and the table, which every date would otherwise allocate again
+            sameDate.reset();
+            sameDateRuns.clear();
+            sameDateIndex.reset();
+        }
+        const size_t same = sameDateIndex.find(sameDate.getTransactions(), transaction);
+        if (same != TransactionIndex::NOT_FOUND) {
+            return sameDateRuns[same] != run;
+        }
+        sameDateIndex.insert(sameDate.getTransactions(), transaction, sameDate.size());
+        Transaction& copy = sameDate.add();
+        copy = transaction;
+        copy.setName(sameDate.storeName(transaction.getName()));
+        sameDateRuns.push_back(run);
+        return false;
+    };
+
+    size_t duplicateCount = 0;
+    while (!heads.empty()) {
+        const size_t run = heads.top().run;
+        heads.pop();
+        const Transaction& transaction = run == memoryRunIdx ? memoryRun[memoryPosition++] : readers[run].current;
+        if (deduplicate && isDuplicate(transaction, run)) {
+            duplicateCount++;
+        }
+        else {
+            sink(transaction);
+        }
+        advance(run);
+    }
+    return duplicateCount;
+}
+
+std::string ExternalMerge::nextPath() {
+    return directory + "/" + constants::SPILL_FILE_PREFIX + std::to_string(fileCount++) + ".bin";
+}
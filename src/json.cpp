@@ -0,0 +1,30 @@
+/**
+ * @file json.cpp
+ * @brief Source file for the helpers that the JSON reports are written with.
+ */
+#include <iomanip>
+#include "wells_fargo_statement_converter/json.h"
+
+namespace json {
+
+void writeString(std::ostream& stream, const std::string_view text) {
+    stream << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            stream << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            const std::ios_base::fmtflags flags = stream.flags();
+            const char fill = stream.fill();
+            stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+            stream.flags(flags);
+            stream.fill(fill);
+        }
+        else {
+            stream << c;
+        }
+    }
+    stream << '"';
+}
+
+} // namespace json
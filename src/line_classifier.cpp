@@ -0,0 +1,510 @@
+/**
+ * @file line_classifier.cpp
+ * @brief Source file for the LineClassifier class.
+ */
+#include <atomic>
+#include <cstdint>
+#include <regex>
+#include <string>
+#include "wells_fargo_statement_converter/line_classifier.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LINE_CLASSIFIER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LINE_CLASSIFIER_SSE2
+#endif
+#if defined(_MSC_VER) && (defined(LINE_CLASSIFIER_AVX2) || defined(LINE_CLASSIFIER_SSE2))
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr size_t NPOS = std::string_view::npos;
+constexpr size_t MAX_LEADING_TOKENS = 7; /**< The interest charge layout has the most fixed tokens: 2 dates and 4 words */
+
+std::atomic<size_t> mismatchCount{0};
+
+/**
+ * @brief Same characters as "\s" in the regex patterns.
+ */
+inline bool isSpace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+inline bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Characters that "." in the regex patterns doesn't match.
+ */
+inline bool isLineTerminator(const char c) {
+    return c == '\n' || c == '\r';
+}
+
+struct Token {
+    size_t begin = 0;
+    size_t end = 0;
+
+    size_t length() const {
+        return end - begin;
+    }
+};
+
+/**
+ * @brief Everything the scanner needs to know about a line, collected in a single pass.
+ */
+struct LineTokens {
+    size_t count = 0; /**< The total number of whitespace separated tokens */
+    Token leading[MAX_LEADING_TOKENS]; /**< The first tokens of the line */
+    Token last; /**< The last token of the line */
+    size_t lastRunBegin = NPOS; /**< Where the whitespace in front of the last token starts */
+    size_t lastTerminatorBeforeLastRun = NPOS; /**< The position of the last "\n" or "\r" in front of that whitespace */
+    bool hasDollar = false;
+    bool hasAmount = false; /**< Has something that matches "(\d|,)+\.\d{2}" anywhere */
+};
+
+LineTokens tokenize(const std::string_view line) {
+    LineTokens tokens;
+    bool inToken = false;
+    size_t runBegin = 0;
+    size_t lastTerminator = NPOS;
+    size_t terminatorAtRunBegin = NPOS;
+
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (isSpace(c)) {
+            if (inToken) {
+                inToken = false;
+                tokens.last.end = i;
+                if (tokens.count <= MAX_LEADING_TOKENS) {
+                    tokens.leading[tokens.count - 1].end = i;
+                }
+                runBegin = i;
+                terminatorAtRunBegin = lastTerminator;
+            }
+            if (isLineTerminator(c)) {
+                lastTerminator = i;
+            }
+            continue;
+        }
+
+        if (!inToken) {
+            inToken = true;
+            if (tokens.count > 0) {
+                tokens.lastRunBegin = runBegin;
+                tokens.lastTerminatorBeforeLastRun = terminatorAtRunBegin;
+            }
+            tokens.last.begin = i;
+            if (tokens.count < MAX_LEADING_TOKENS) {
+                tokens.leading[tokens.count].begin = i;
+            }
+            tokens.count++;
+        }
+
+        if (c == '$') {
+            tokens.hasDollar = true;
+        }
+        else if (c == '.' && !tokens.hasAmount && i > 0 && (isDigit(line[i - 1]) || line[i - 1] == ',')
+            && i + 2 < line.size() && isDigit(line[i + 1]) && isDigit(line[i + 2])) {
+            tokens.hasAmount = true;
+        }
+    }
+
+    if (inToken) {
+        tokens.last.end = line.size();
+        if (tokens.count <= MAX_LEADING_TOKENS) {
+            tokens.leading[tokens.count - 1].end = line.size();
+        }
+    }
+    return tokens;
+}
+
+/**
+ * @brief "\d{2}/\d{2}"
+ */
+bool isDate(const std::string_view line, const Token& token) {
+    return token.length() == 5 && isDigit(line[token.begin]) && isDigit(line[token.begin + 1]) && line[token.begin + 2] == '/'
+        && isDigit(line[token.begin + 3]) && isDigit(line[token.begin + 4]);
+}
+
+/**
+ * @brief "\d+"
+ */
+bool isNumber(const std::string_view line, const Token& token) {
+    for (size_t i = token.begin; i < token.end; ++i) {
+        if (!isDigit(line[i])) {
+            return false;
+        }
+    }
+    return token.length() > 0;
+}
+
+/**
+ * @brief "(\d|,)+\.\d{2}"
+ */
+bool isAmount(const std::string_view line, const Token& token) {
+    if (token.length() < 4 || line[token.end - 3] != '.' || !isDigit(line[token.end - 2]) || !isDigit(line[token.end - 1])) {
+        return false;
+    }
+    for (size_t i = token.begin; i < token.end - 3; ++i) {
+        if (!isDigit(line[i]) && line[i] != ',') {
+            return false;
+        }
+    }
+    return true;
+}
+
+FieldSpan toSpan(const Token& token) {
+    return FieldSpan{token.begin, token.length()};
+}
+
+/**
+ * @brief Finds the name for the "(\S+)\s+(.+?)\s+((\d|,)+\.\d{2})\s*$" part of the transaction patterns.
+ *
+ * Normally the name runs from the token after the reference number up to the whitespace in front of the amount. If
+ * there's nothing between the reference number and the amount, the regex still matches by using a single whitespace
+ * character as the name, as long as there are at least 3 whitespace characters. That case is reproduced here too.
+ *
+ * @param std::string_view The line.
+ * @param LineTokens The tokens of the line.
+ * @param size_t The index of the reference number token.
+ * @param FieldSpan Where the name is saved.
+ *
+ * @return Whether or not a name could be matched.
+ */
+bool findName(const std::string_view line, const LineTokens& tokens, const size_t refIdx, FieldSpan& name) {
+    if (tokens.count > refIdx + 2) {
+        const size_t nameBegin = tokens.leading[refIdx + 1].begin;
+        if (tokens.lastTerminatorBeforeLastRun != NPOS && tokens.lastTerminatorBeforeLastRun >= nameBegin) {
+            return false; // "." doesn't match line terminators
+        }
+        name = FieldSpan{nameBegin, tokens.lastRunBegin - nameBegin};
+        return true;
+    }
+
+    if (tokens.count == refIdx + 2) {
+        // The regex takes the last character it can from the whitespace between the reference number and the amount,
+        // leaving at least one character for the "\s+" on either side.
+        const size_t refEnd = tokens.leading[refIdx].end;
+        for (size_t i = tokens.last.begin - 2; i > refEnd && i != NPOS; --i) {
+            if (!isLineTerminator(line[i])) {
+                name = FieldSpan{i, 1};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief "^\s*(\d+)\s+(\d{2}/\d{2})\s+(\d{2}/\d{2})\s+(\S+)\s+(.+?)\s+((\d|,)+\.\d{2})\s*$"
+ */
+bool matchTransaction(const std::string_view line, const LineTokens& tokens, LineMatch& match) {
+    if (tokens.count < 5 || !isNumber(line, tokens.leading[0]) || !isDate(line, tokens.leading[1]) || !isDate(line, tokens.leading[2])) {
+        return false;
+    }
+    if (!findName(line, tokens, 3, match.name)) {
+        return false;
+    }
+    match.lastFour = toSpan(tokens.leading[0]);
+    match.transactionDate = toSpan(tokens.leading[1]);
+    match.postDate = toSpan(tokens.leading[2]);
+    match.referenceNum = toSpan(tokens.leading[3]);
+    match.amount = toSpan(tokens.last);
+    return true;
+}
+
+/**
+ * @brief "^\s*(\d{2}/\d{2})\s+(\d{2}/\d{2})\s+INTEREST CHARGE ON PURCHASES\s+((\d|,)+\.\d{2})\s*$"
+ */
+bool matchInterest(const std::string_view line, const LineTokens& tokens, LineMatch& match) {
+    const std::string& interest = constants::regex::INTEREST_CHARGE;
+    if (tokens.count < 4 || !isDate(line, tokens.leading[0]) || !isDate(line, tokens.leading[1])) {
+        return false;
+    }
+    const size_t interestBegin = tokens.leading[2].begin;
+    if (tokens.lastRunBegin != interestBegin + interest.size() || line.compare(interestBegin, interest.size(), interest) != 0) {
+        return false;
+    }
+    match.transactionDate = toSpan(tokens.leading[0]);
+    match.postDate = toSpan(tokens.leading[1]);
+    match.amount = toSpan(tokens.last);
+    return true;
+}
+
+/**
+ * @brief "^\s*(\d{2}/\d{2})\s+(\d{2}/\d{2})\s+(\S+)\s+(.+?)\s+((\d|,)+\.\d{2})\s*$"
+ */
+bool matchTransactionOld(const std::string_view line, const LineTokens& tokens, LineMatch& match) {
+    if (tokens.count < 4 || !isDate(line, tokens.leading[0]) || !isDate(line, tokens.leading[1])) {
+        return false;
+    }
+    if (!findName(line, tokens, 2, match.name)) {
+        return false;
+    }
+    match.transactionDate = toSpan(tokens.leading[0]);
+    match.postDate = toSpan(tokens.leading[1]);
+    match.referenceNum = toSpan(tokens.leading[2]);
+    match.amount = toSpan(tokens.last);
+    return true;
+}
+
+bool isSkipListed(const std::string_view line) {
+    return line.find(constants::regex::ONLINE_PAYMENT) != NPOS || line.find(constants::regex::LAST_STATEMENT_BALANCE) != NPOS;
+}
+
+/**
+ * @brief Checks the character at "position", which is a '.' or a '$', for the start of something relevant.
+ */
+inline bool isRelevantAt(const std::string_view text, const size_t position) {
+    return text[position] == '$' || (position > 0 && position + 2 < text.size() && (isDigit(text[position - 1]) || text[position - 1] == ',')
+        && isDigit(text[position + 1]) && isDigit(text[position + 2]));
+}
+
+#if defined(LINE_CLASSIFIER_AVX2) || defined(LINE_CLASSIFIER_SSE2)
+/**
+ * @brief The index of the lowest set bit. The mask can't be 0.
+ */
+inline unsigned int lowestBit(const uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long bit = 0;
+    _BitScanForward(&bit, mask);
+    return static_cast<unsigned int>(bit);
+#else
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+/**
+ * @brief Checks if the text has a '$' or something that matches "(\d|,)+\.\d{2}".
+ *
+ * Relevant text always has a '.' or a '$', and most lines have neither, so those two characters are searched for in
+ * blocks of 32 (AVX2) or 16 (SSE2) bytes. Only the positions they are found at are looked at more closely.
+ */
+bool hasRelevantToken(const std::string_view text) {
+    const char* data = text.data();
+    const size_t size = text.size();
+    size_t i = 0;
+
+#if defined(LINE_CLASSIFIER_AVX2)
+    const __m256i dots = _mm256_set1_epi8('.');
+    const __m256i dollars = _mm256_set1_epi8('$');
+    for (; i + 32 <= size; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, dots), _mm256_cmpeq_epi8(block, dollars))));
+        while (mask != 0) {
+            if (isRelevantAt(text, i + lowestBit(mask))) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+#elif defined(LINE_CLASSIFIER_SSE2)
+    const __m128i dots = _mm_set1_epi8('.');
+    const __m128i dollars = _mm_set1_epi8('$');
+    for (; i + 16 <= size; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, dots), _mm_cmpeq_epi8(block, dollars))));
+        while (mask != 0) {
+            if (isRelevantAt(text, i + lowestBit(mask))) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        if ((data[i] == '.' || data[i] == '$') && isRelevantAt(text, i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @struct Patterns
+ * @brief The std::regex objects for the patterns in constants::regex.
+ */
+struct Patterns {
+    const std::regex transaction{constants::regex::TRANSACTION};
+    const std::regex transactionOld{constants::regex::TRANSACTION_OLD};
+    const std::regex transactionInterest{constants::regex::TRANSACTION_INTEREST};
+    const std::regex transactionTitle{constants::regex::TRANSACTION_SECTION_TITLE};
+    const std::regex transactionSkip{constants::regex::SKIP_LIST};
+    const std::regex skippedRelevant{constants::regex::SKIPPED_RELEVANT};
+    const std::regex lastFour{constants::regex::LAST_FOUR};
+};
+
+/**
+ * @brief The patterns are only compiled the first time the regex path is used, so the scanner never pays for them.
+ */
+const Patterns& getPatterns() {
+    static const Patterns patterns;
+    return patterns;
+}
+
+FieldSpan toSpan(const std::cmatch& match, const size_t group) {
+    return FieldSpan{static_cast<size_t>(match.position(group)), static_cast<size_t>(match.length(group))};
+}
+
+} // namespace
+
+/**
+ * Lines that don't get past the prefilter are irrelevant no matter which patterns are used. In ClassifierMode::Verify
+ * every line is run through both the scanner and the regex patterns, and the prefilter is checked against them too.
+ */
+LineMatch LineClassifier::classify(const std::string_view line, const ClassifierMode mode) {
+    switch (mode) {
+        case ClassifierMode::Scanner:
+            return prefilter(line) ? scan(line) : LineMatch();
+        case ClassifierMode::Regex:
+            return prefilter(line) ? matchRegex(line) : LineMatch();
+        case ClassifierMode::Verify:
+            break;
+    }
+
+    const LineMatch regexMatch = matchRegex(line);
+    if (!(scan(line) == regexMatch)) {
+        mismatchCount++;
+        LOG_INFO("Classifier mismatch. The scanner and the regex patterns disagree on line: ", line, "\n");
+    }
+    if (!prefilter(line) && regexMatch.kind != LineKind::Irrelevant) {
+        mismatchCount++;
+        LOG_INFO("Classifier mismatch. The prefilter rejected a line the regex patterns matched: ", line, "\n");
+    }
+    return regexMatch;
+}
+
+bool LineClassifier::prefilter(const std::string_view line) {
+    return hasRelevantToken(line);
+}
+
+/**
+ * The line is split into whitespace separated tokens once. Since the amount has to be the last token and everything
+ * else has a fixed position at the start of the line, each layout can then be checked by looking at a few tokens.
+ * The layouts are checked in the same order as the regex path, so lines that fit more than one layout get the same kind.
+ */
+LineMatch LineClassifier::scan(const std::string_view line) {
+    LineMatch match;
+    const LineTokens tokens = tokenize(line);
+
+    const bool endsInAmount = tokens.count >= 2 && isAmount(line, tokens.last);
+    if (endsInAmount && matchTransaction(line, tokens, match)) {
+        match.kind = LineKind::Transaction;
+    }
+    else if (endsInAmount && matchInterest(line, tokens, match)) {
+        match.kind = LineKind::TransactionInterest;
+    }
+    else if (endsInAmount && matchTransactionOld(line, tokens, match)) {
+        match.kind = LineKind::TransactionOld;
+    }
+    else {
+        match = LineMatch();
+        match.kind = (tokens.hasAmount || tokens.hasDollar) ? LineKind::SkippedRelevant : LineKind::Irrelevant;
+        return match;
+    }
+
+    if (isSkipListed(line)) {
+        match.kind = LineKind::SkipListed;
+    }
+    return match;
+}
+
+/**
+ * The transaction patterns are checked in order. A line that matches one of them, but has something from the
+ * skip list in it, is treated as skipped.
+ */
+LineMatch LineClassifier::matchRegex(const std::string_view line) {
+    const Patterns& patterns = getPatterns();
+    LineMatch match;
+    std::cmatch groups;
+    const char* begin = line.data();
+    const char* end = line.data() + line.size();
+
+    if (std::regex_match(begin, end, groups, patterns.transaction)) {
+        match.kind = LineKind::Transaction; // Normal transactions
+        match.lastFour = toSpan(groups, 1);
+        match.transactionDate = toSpan(groups, 2);
+        match.postDate = toSpan(groups, 3);
+        match.referenceNum = toSpan(groups, 4);
+        match.name = toSpan(groups, 5);
+        match.amount = toSpan(groups, 6);
+    }
+    else if (std::regex_match(begin, end, groups, patterns.transactionInterest)) {
+        match.kind = LineKind::TransactionInterest; // Interest charges
+        match.transactionDate = toSpan(groups, 1);
+        match.postDate = toSpan(groups, 2);
+        match.amount = toSpan(groups, 3);
+    }
+    else if (std::regex_match(begin, end, groups, patterns.transactionOld)) {
+        match.kind = LineKind::TransactionOld; // Normal transactions that use the old format.
+        match.transactionDate = toSpan(groups, 1);
+        match.postDate = toSpan(groups, 2);
+        match.referenceNum = toSpan(groups, 3);
+        match.name = toSpan(groups, 4);
+        match.amount = toSpan(groups, 5);
+    }
+    else if (std::regex_search(begin, end, patterns.skippedRelevant)) {
+        match.kind = LineKind::SkippedRelevant; // Skipped, but possibly relevant lines
+        return match;
+    }
+    else {
+        return match;
+    }
+
+    if (std::regex_search(begin, end, patterns.transactionSkip)) {
+        match.kind = LineKind::SkipListed;
+    }
+    return match;
+}
+
+bool LineClassifier::isLastFourLine(const std::string_view line, const ClassifierMode mode) {
+    const bool scanned = line.find(constants::regex::ENDING_IN) != NPOS || line.find(constants::regex::ACCOUNT_ENDING_IN) != NPOS;
+    if (mode == ClassifierMode::Scanner) {
+        return scanned;
+    }
+
+    const bool matched = std::regex_search(line.data(), line.data() + line.size(), getPatterns().lastFour);
+    if (mode == ClassifierMode::Verify && scanned != matched) {
+        mismatchCount++;
+        LOG_INFO("Classifier mismatch on the last four pattern for line: ", line, "\n");
+    }
+    return matched;
+}
+
+bool LineClassifier::isTitleLine(const std::string_view line, const ClassifierMode mode) {
+    const bool scanned = line.find(constants::regex::TRANSACTION_SECTION_TITLE) != NPOS;
+    if (mode == ClassifierMode::Scanner) {
+        return scanned;
+    }
+
+    const bool matched = std::regex_search(line.data(), line.data() + line.size(), getPatterns().transactionTitle);
+    if (mode == ClassifierMode::Verify && scanned != matched) {
+        mismatchCount++;
+        LOG_INFO("Classifier mismatch on the transaction title pattern for line: ", line, "\n");
+    }
+    return matched;
+}
+
+/**
+ * None of the patterns span multiple lines, so searching the whole page gives the same answer as searching each line.
+ */
+PageFeatures LineClassifier::scanPage(const std::string_view text) {
+    PageFeatures features;
+    features.hasLastFour = text.find(constants::regex::ENDING_IN) != NPOS || text.find(constants::regex::ACCOUNT_ENDING_IN) != NPOS;
+    features.hasTitle = text.find(constants::regex::TRANSACTION_SECTION_TITLE) != NPOS;
+    features.hasRelevant = hasRelevantToken(text);
+    features.hasSectionEnd = text.find(constants::regex::TRANSACTION_SECTION_END) != NPOS;
+    return features;
+}
+
+size_t LineClassifier::getMismatchCount() {
+    return mismatchCount.load();
+}
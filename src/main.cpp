@@ -2,60 +2,237 @@
  * @file main.cpp
  * @brief See the README.md file for an overview.
  */
+#include <algorithm>
+#include <atomic>
+#include <csignal>
 #include <thread>
 #include <chrono>
 #include <filesystem>
-#include "logger/log.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include "wells_fargo_statement_converter/log_level.h"
 #include "wells_fargo_statement_converter/pdf_processor.h"
 #include "wells_fargo_statement_converter/exception_rk.h"
 #include "wells_fargo_statement_converter/constants.h"
-#include "wells_fargo_statement_converter/quick_sort.h"
+#include "wells_fargo_statement_converter/options.h"
+#include "wells_fargo_statement_converter/directory_watcher.h"
 
 LOG_SETUP
 
-int main() {
+namespace {
+
+std::atomic<bool> stopRequested(false); /**< Set by Ctrl+C in watch mode */
+
+void requestStop(int) {
+    stopRequested = true;
+}
+
+/**
+ * @brief Creates a processor with the settings from the command line.
+ * 
+ * @param Options The command line options.
+ * 
+ * @return The processor.
+ */
+std::unique_ptr<PdfProcessor> createProcessor(const Options& options) {
+    std::unique_ptr<PdfProcessor> pdfProcessor = std::make_unique<PdfProcessor>();
+    pdfProcessor->setThreadCount(options.threadCount);
+    pdfProcessor->setPageThreadCount(options.pageThreadCount);
+    pdfProcessor->setPrefetchCount(options.prefetchCount);
+    pdfProcessor->setClassifierMode(options.classifierMode);
+    pdfProcessor->setPagePruning(options.pagePruning);
+    pdfProcessor->setStopAtSectionEnd(options.stopAtSectionEnd);
+    pdfProcessor->setTextRegion(options.textRegion);
+    pdfProcessor->setCacheEnabled(options.cacheEnabled);
+    pdfProcessor->setDeduplication(options.deduplication);
+    pdfProcessor->setColumnarEnabled(options.columnar);
+    pdfProcessor->setSummaryEnabled(options.summary);
+    pdfProcessor->setRecursive(options.recursive);
+    pdfProcessor->setAccountFilesEnabled(options.accountFiles);
+    pdfProcessor->setCombinedFileEnabled(options.combinedFile);
+    pdfProcessor->setMemoryBudget(static_cast<size_t>(options.memoryBudget) * 1024 * 1024);
+    return pdfProcessor;
+}
+
+/**
+ * @brief Converts every statement in the statements directory, from scratch.
+ * 
+ * @param Options The command line options.
+ * 
+ * @return The processor, which holds the sorted transactions so watch mode can add to them.
+ */
+std::unique_ptr<PdfProcessor> convert(const Options& options) {
+    std::unique_ptr<PdfProcessor> pdfProcessor = createProcessor(options);
+    pdfProcessor->setStatisticsEnabled(options.statisticsEnabled);
+    pdfProcessor->setTraceEnabled(options.traceEnabled);
+    pdfProcessor->gatherPdfFiles(options.inputDirectories);
+    pdfProcessor->closeSkippedFilesFile();
+
+    pdfProcessor->processPdfs(options.inputDirectories.front());
+    pdfProcessor->closeSkippedLinesFile();
+
+    pdfProcessor->sortTransactions();
+    pdfProcessor->printAllTransactions();
+
+    pdfProcessor->generateCsvFile(constants::CSV_FILE_NAME);
+
+    if (options.statisticsEnabled) {
+        pdfProcessor->writeStatistics(constants::STATISTICS_FILE_NAME);
+    }
+    pdfProcessor->writeTrace(constants::TRACE_FILE_NAME);
+    return pdfProcessor;
+}
+
+/**
+ * @brief Converts every statement, then keeps converting new ones as they show up until Ctrl+C is pressed.
+ * 
+ * New statements are merged into the transactions that are already sorted. If a statement was changed or removed, or
+ * the last conversion failed, everything is converted again, which is cheap for unchanged statements with the cache.
+ * Errors are logged and the watching goes on.
+ * 
+ * @param Options The command line options.
+ */
+void watch(const Options& options) {
+    const std::string directory = options.inputDirectories.front();
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // Start watching before the first conversion, so statements that show up during it aren't missed
+    DirectoryWatcher watcher(directory, std::chrono::milliseconds(options.pollInterval));
+    std::unique_ptr<PdfProcessor> pdfProcessor;
+    try {
+        pdfProcessor = convert(options);
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Caught exception: \"", e.what(), "\". Trying again once the statements change\n");
+    }
+
+    LOG_INFO("Watching ", directory, " for new statements. Press Ctrl+C to stop\n");
+    while (!stopRequested) {
+        const DirectoryWatcher::Changes changes = watcher.waitForChanges(stopRequested);
+        if (changes.empty()) {
+            continue;
+        }
+
+        bool changedStatement = false;
+        for (const auto* paths : {&changes.modified, &changes.removed}) {
+            for (const auto& path : *paths) {
+                changedStatement = changedStatement || PdfProcessor::isPdfFileName(std::filesystem::path(path).filename().string());
+            }
+        }
+
+        try {
+            if (!pdfProcessor || changedStatement) {
+                LOG_INFO("Converting every statement again\n");
+                pdfProcessor.reset();
+                pdfProcessor = convert(options);
+                continue;
+            }
+            pdfProcessor->processNewPdfs(changes.added);
+            pdfProcessor->updateCsvFile(constants::CSV_FILE_NAME);
+            if (options.statisticsEnabled) {
+                pdfProcessor->writeStatistics(constants::STATISTICS_FILE_NAME);
+            }
+            pdfProcessor->writeTrace(constants::TRACE_FILE_NAME);
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR("Caught exception: \"", e.what(), "\". Trying again once the statements change\n");
+            pdfProcessor.reset();
+        }
+    }
+    LOG_INFO("Stopped watching ", directory, "\n");
+}
+
+/**
+ * @brief Converts statements for another program, which keeps this one running so it only starts up once.
+ * 
+ * Each line on stdin is the path to a statement. For each one, "OK <N>" and then its N transactions as CSV rows, sorted
+ * by date, are written to stdout. If it can't be converted, "ERROR <message>" is written instead. It stops once stdin
+ * is closed.
+ * 
+ * @param Options The command line options.
+ */
+void serve(const Options& options) {
+    LOG_INFO("Converting the statements named on stdin\n");
+    std::unique_ptr<PdfProcessor> pdfProcessor = createProcessor(options);
+    std::ios::sync_with_stdio(false);
+
+    std::string path;
+    std::string response;
+    while (std::getline(std::cin, path)) {
+        if (!path.empty() && path.back() == '\r') {
+            path.pop_back();
+        }
+        if (path.empty()) {
+            continue;
+        }
+
+        LOG_DEBUG("Converting ", path, "\n");
+        response.clear();
+        try {
+            const StatementResult result = pdfProcessor->convertFile(path);
+            response += "OK " + std::to_string(result.transactions.size()) + "\n";
+            for (const auto& transaction : result.transactions) {
+                transaction.appendCsvFormat(response);
+                response += '\n';
+            }
+        }
+        catch (const std::exception& e) {
+            std::string message = e.what();
+            std::replace(message.begin(), message.end(), '\n', ' ');
+            LOG_ERROR("Couldn't convert ", path, ": \"", message, "\"\n");
+            response = "ERROR " + message + "\n";
+        }
+        std::cout << response << std::flush;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
     LOG_VERIFY
     std::thread logThread = rk::log::startLogThread();
     const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
-    LOG("Starting program\n");
+    LOG_INFO("Starting program\n");
 
     try {         
+        const Options options = Options::parse(argc, argv);
+
         if (!std::filesystem::exists(constants::OUTPUT_DIRECTORY)) {
             std::filesystem::create_directory(constants::OUTPUT_DIRECTORY);
         }
-        
-        PdfProcessor pdfProcessor;
-        pdfProcessor.gatherPdfFiles("./" + constants::PDF_DIRECTORY);
-        pdfProcessor.closeSkippedFilesFile();
- 
-        pdfProcessor.processPdfs("./" + constants::PDF_DIRECTORY);
-        pdfProcessor.closeSkippedLinesFile();
 
-        pdfProcessor.sortTransactions();
-        pdfProcessor.printAllTransactions();
-   
-        pdfProcessor.generateCsvFile(constants::CSV_FILE_NAME);
+        if (options.serve) {
+            serve(options);
+        }
+        else if (options.watch) {
+            watch(options);
+        }
+        else {
+            convert(options);
+        }
     }
     catch (const Exception& e) {
-        LOG("Caught exception: \"", e.what(), "\"\n");
+        LOG_ERROR("Caught exception: \"", e.what(), "\"\n");
         std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
         auto duration = endTime - startTime;
-        LOG("Exiting due to exception. Program took: ", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0, " sec\n");
+        LOG_ERROR("Exiting due to exception. Program took: ", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0, " sec\n");
         rk::log::endLogThread(logThread);
         rk::log::closeLogFile();
     }
     catch (const std::filesystem::filesystem_error& e) {
-        LOG("Caught a file exception: \"", e.what(), "\"\n");
+        LOG_ERROR("Caught a file exception: \"", e.what(), "\"\n");
         std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
         auto duration = endTime - startTime;
-        LOG("Exiting due to exception. Program took: ", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0, " sec\n");
+        LOG_ERROR("Exiting due to exception. Program took: ", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0, " sec\n");
         rk::log::endLogThread(logThread);
         rk::log::closeLogFile();
     }
 
     std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
     auto duration = endTime - startTime;
-    LOG("Finished successfully. Program took: ", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0, " sec\n");
+    LOG_INFO("Finished successfully. Program took: ", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() / 1000.0, " sec\n");
 
     rk::log::endLogThread(logThread);
     rk::log::closeLogFile();
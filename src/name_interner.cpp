@@ -0,0 +1,91 @@
+/**
+ * @file name_interner.cpp
+ * @brief Source file for the NameInterner class.
+ */
+#include <algorithm>
+#include "wells_fargo_statement_converter/name_interner.h"
+
+namespace {
+
+constexpr size_t MIN_SLOTS = 256;
+
+} // namespace
+
+/**
+ * Linear probing. The table is kept at most 70% full, so the runs of used slots stay short.
+ */
+uint32_t NameInterner::intern(const std::string_view name) {
+    if ((names.size() + 1) * 10 > slots.size() * 7) {
+        grow();
+    }
+
+    const uint64_t nameHash = hash(name);
+    const uint32_t tag = static_cast<uint32_t>(nameHash >> 32);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = nameHash & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.id == EMPTY) {
+            slot.id = static_cast<uint32_t>(names.size());
+            slot.tag = tag;
+            names.push_back(arena.store(name));
+            return slot.id;
+        }
+        if (slot.tag == tag && names[slot.id] == name) {
+            return slot.id;
+        }
+    }
+}
+
+std::string_view NameInterner::getName(const uint32_t id) const {
+    return names[id];
+}
+
+size_t NameInterner::size() const {
+    return names.size();
+}
+
+void NameInterner::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    names.clear();
+    names.shrink_to_fit();
+    arena.clear();
+}
+
+/**
+ * FNV-1a, finished with the mixing step of splitmix64 so the lower bits, which pick the slot, depend on every character.
+ */
+uint64_t NameInterner::hash(const std::string_view name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+/**
+ * The hashes aren't kept, so they are taken again from the names.
+ */
+void NameInterner::grow() {
+    std::vector<Slot> oldSlots(std::max(MIN_SLOTS, slots.size() * 2));
+    oldSlots.swap(slots);
+
+    const size_t mask = slots.size() - 1;
+    for (const Slot& oldSlot : oldSlots) {
+        if (oldSlot.id == EMPTY) {
+            continue;
+        }
+        size_t i = hash(names[oldSlot.id]) & mask;
+        while (slots[i].id != EMPTY) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = oldSlot;
+    }
+}
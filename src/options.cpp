@@ -0,0 +1,182 @@
+/**
+ * @file options.cpp
+ * @brief Source file for the Options struct.
+ */
+#include <string>
+#include "wells_fargo_statement_converter/options.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+
+namespace {
+
+/**
+ * @brief Converts the value of a numeric argument, throwing if it isn't a positive number.
+ */
+unsigned int parsePositive(const std::string& name, const std::string& value) {
+    size_t parsed = 0;
+    unsigned long result = 0;
+    try {
+        result = std::stoul(value, &parsed);
+    }
+    catch (const std::exception&) {
+        parsed = 0;
+    }
+    if (parsed != value.size() || result == 0) {
+        throw Exception("Invalid value \"" + value + "\" for " + name);
+    }
+    return static_cast<unsigned int>(result);
+}
+
+/**
+ * @brief Converts the value of --text-region, "<x>,<y>,<width>,<height>", throwing if it is malformed.
+ */
+TextRegion parseRegion(const std::string& name, const std::string& value) {
+    double numbers[4] = {};
+    size_t position = 0;
+    for (int i = 0; i < 4; ++i) {
+        size_t parsed = 0;
+        try {
+            numbers[i] = std::stod(value.substr(position), &parsed);
+        }
+        catch (const std::exception&) {
+            parsed = 0;
+        }
+        position += parsed;
+        const char expected = (i < 3) ? ',' : '\0';
+        if (parsed == 0 || (position < value.size() ? value[position] : '\0') != expected) {
+            throw Exception("Invalid value \"" + value + "\" for " + name);
+        }
+        position++;
+    }
+
+    TextRegion region;
+    region.x = numbers[0];
+    region.y = numbers[1];
+    region.width = numbers[2];
+    region.height = numbers[3];
+    if (region.isEmpty()) {
+        throw Exception("Invalid value \"" + value + "\" for " + name);
+    }
+    return region;
+}
+
+} // namespace
+
+/**
+ * Goes through the arguments one by one. Arguments that take a value read it from the next argument.
+ * Unknown arguments throw an Exception so typos don't silently fall back to the defaults.
+ */
+Options Options::parse(const int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto nextValue = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw Exception("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--input") {
+            options.inputDirectories.push_back(nextValue());
+        }
+        else if (arg == "--recursive") {
+            options.recursive = true;
+        }
+        else if (arg == "--threads" || arg == "-j") {
+            options.threadCount = parsePositive(arg, nextValue());
+        }
+        else if (arg == "--page-threads") {
+            options.pageThreadCount = parsePositive(arg, nextValue());
+        }
+        else if (arg == "--prefetch") {
+            options.prefetchCount = parsePositive(arg, nextValue());
+        }
+        else if (arg == "--classifier") {
+            const std::string value = nextValue();
+            if (value == "scanner") {
+                options.classifierMode = ClassifierMode::Scanner;
+            }
+            else if (value == "regex") {
+                options.classifierMode = ClassifierMode::Regex;
+            }
+            else if (value == "verify") {
+                options.classifierMode = ClassifierMode::Verify;
+            }
+            else {
+                throw Exception("Invalid value \"" + value + "\" for " + arg);
+            }
+        }
+        else if (arg == "--cache") {
+            options.cacheEnabled = true;
+        }
+        else if (arg == "--columnar") {
+            options.columnar = true;
+        }
+        else if (arg == "--per-account") {
+            options.accountFiles = true;
+        }
+        else if (arg == "--no-combined") {
+            options.combinedFile = false;
+        }
+        else if (arg == "--summary") {
+            options.summary = true;
+        }
+        else if (arg == "--dedup") {
+            options.deduplication = true;
+        }
+        else if (arg == "--memory-budget") {
+            options.memoryBudget = parsePositive(arg, nextValue());
+        }
+        else if (arg == "--no-page-pruning") {
+            options.pagePruning = false;
+        }
+        else if (arg == "--stop-at-section-end") {
+            options.stopAtSectionEnd = true;
+        }
+        else if (arg == "--text-region") {
+            options.textRegion = parseRegion(arg, nextValue());
+        }
+        else if (arg == "--trace") {
+            options.traceEnabled = true;
+        }
+        else if (arg == "--stats") {
+            options.statisticsEnabled = true;
+        }
+        else if (arg == "--watch") {
+            options.watch = true;
+        }
+        else if (arg == "--serve") {
+            options.serve = true;
+        }
+        else if (arg == "--poll-interval") {
+            options.pollInterval = parsePositive(arg, nextValue());
+        }
+        else {
+            throw Exception("Unknown argument \"" + arg + "\"");
+        }
+    }
+
+    if (options.watch && (options.inputDirectories.size() > 1 || options.recursive)) {
+        throw Exception("--watch can only watch a single directory, without --recursive");
+    }
+    if (options.inputDirectories.empty()) {
+        options.inputDirectories.push_back("./" + constants::PDF_DIRECTORY);
+    }
+    if (!options.combinedFile && !options.accountFiles) {
+        throw Exception("--no-combined only works with --per-account");
+    }
+    if (options.accountFiles && options.memoryBudget > 0) {
+        throw Exception("--per-account can't be used with --memory-budget");
+    }
+    if (options.watch && options.serve) {
+        throw Exception("--watch and --serve can't be used together");
+    }
+    if (options.watch && options.memoryBudget > 0) {
+        throw Exception("--memory-budget can't be used with --watch, which keeps every transaction in memory");
+    }
+    if (options.serve && (options.deduplication || options.memoryBudget > 0)) {
+        throw Exception("--dedup and --memory-budget can't be used with --serve, which converts each statement on its own");
+    }
+    return options;
+}
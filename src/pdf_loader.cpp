@@ -0,0 +1,111 @@
+/**
+ * @file pdf_loader.cpp
+ * @brief Source file for the PdfLoader class.
+ */
+#include <algorithm>
+#include <fstream>
+#include <utility>
+#include "wells_fargo_statement_converter/pdf_loader.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+PdfLoader::PdfLoader(const std::vector<std::string>& pFiles, const size_t pPrefetchCount) : files(pFiles), prefetchCount(pPrefetchCount) {
+    if (prefetchCount > 0 && !files.empty()) {
+        LOG_INFO("Prefetching up to ", prefetchCount, " statements\n");
+        slots.resize(files.size());
+        prefetchThread = std::thread(&PdfLoader::prefetchLoop, this);
+    }
+}
+
+PdfLoader::~PdfLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    slotTaken.notify_all();
+    if (prefetchThread.joinable()) {
+        prefetchThread.join();
+    }
+}
+
+/**
+ * Without prefetching, the statement is simply read into the buffer. Otherwise the prefetched statement is swapped into
+ * the buffer, and the buffer's old memory is kept for the prefetch thread to read a later statement into.
+ */
+void PdfLoader::load(const size_t index, std::vector<char>& buffer) {
+    if (!prefetchThread.joinable()) {
+        readFile(files[index], buffer);
+        return;
+    }
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        Slot& slot = slots[index];
+        slotReady.wait(lock, [&slot] { return slot.ready; });
+        buffer.swap(slot.data);
+        freeBuffers.push_back(std::move(slot.data));
+        error = slot.error;
+        readyCount--;
+    }
+    slotTaken.notify_one();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * The size is taken up front so the whole file can be read with one call. The buffer only reallocates if the file is
+ * larger than anything it held before.
+ */
+void PdfLoader::readFile(const std::string& file, std::vector<char>& buffer) {
+    std::ifstream pdf(file, std::ios::binary | std::ios::ate);
+    if (!pdf) {
+        LOG_ERROR("Error: Could not open PDF file ", file, ". Exiting\n");
+        throw Exception("Error: Could not open PDF file " + file);
+    }
+
+    const std::streamsize size = pdf.tellg();
+    buffer.resize(static_cast<size_t>(std::max<std::streamsize>(size, 0)));
+    pdf.seekg(0);
+    if (size < 0 || !pdf.read(buffer.data(), size)) {
+        LOG_ERROR("Error: Could not read PDF file ", file, ". Exiting\n");
+        throw Exception("Error: Could not read PDF file " + file);
+    }
+}
+
+void PdfLoader::prefetchLoop() {
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::vector<char> buffer;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotTaken.wait(lock, [this] { return stopping || readyCount < prefetchCount; });
+            if (stopping) {
+                return;
+            }
+            if (!freeBuffers.empty()) {
+                buffer = std::move(freeBuffers.back());
+                freeBuffers.pop_back();
+            }
+        }
+
+        std::exception_ptr error;
+        try {
+            LOG_DEBUG("Prefetching ", files[i], "\n");
+            readFile(files[i], buffer);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[i].data = std::move(buffer);
+            slots[i].error = error;
+            slots[i].ready = true;
+            readyCount++;
+        }
+        slotReady.notify_all();
+    }
+}
@@ -4,208 +4,812 @@
  */
 #include <fstream>
 #include <filesystem>
-#include <regex>
 #include <vector>
 #include <string>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <poppler/cpp/poppler-document.h>
 #include <poppler/cpp/poppler-page.h>
 #include <poppler/cpp/poppler-rectangle.h>
 #include "wells_fargo_statement_converter/pdf_processor.h"
-#include "logger/log.h"
+#include "wells_fargo_statement_converter/log_level.h"
 #include "wells_fargo_statement_converter/exception_rk.h"
 #include "wells_fargo_statement_converter/constants.h"
-#include "wells_fargo_statement_converter/quick_sort.h"
+#include "wells_fargo_statement_converter/run_merge.h"
+#include "wells_fargo_statement_converter/thread_pool.h"
+#include "wells_fargo_statement_converter/line_classifier.h"
+#include "wells_fargo_statement_converter/csv_writer.h"
+#include "wells_fargo_statement_converter/pdf_loader.h"
+#include "wells_fargo_statement_converter/line_reader.h"
 
-std::string PdfProcessor::trim(const std::string str) {
-    LOG("Trimming:", str, "\n");
-    std::string result = str;
-    size_t leading = result.find_first_not_of(" \t\n\r");
-    if (leading != 0) {
-        result = result.substr(leading);
+namespace {
+
+using DocumentPtr = std::unique_ptr<poppler::document>; /**< Poppler hands out documents and pages that the caller has to delete */
+using PagePtr = std::unique_ptr<poppler::page>;
+
+constexpr size_t CSV_CHUNK_ROWS = 8192; /**< The rows that a thread formats at a time when the CSV file is written in parallel */
+
+poppler::rectf toRect(const TextRegion& region) {
+    return poppler::rectf(region.x, region.y, region.width, region.height);
+}
+
+size_t countLines(const std::string_view text) {
+    return std::count(text.begin(), text.end(), '\n') + (!text.empty() && text.back() != '\n');
+}
+
+} // namespace
+
+bool PdfProcessor::isPdfFileName(const std::string_view fileName) {
+    uint32_t statementDate = 0;
+    return parsePdfFileName(fileName, statementDate);
+}
+
+/**
+ * Same as matching constants::regex::PDF_FILE_NAME, which only has fixed-width parts. The "MMDDYY" is read digit by
+ * digit while it is checked, and the year is taken to be in the 2000s.
+ */
+bool PdfProcessor::parsePdfFileName(const std::string_view fileName, uint32_t& statementDate) {
+    if (fileName.size() != constants::regex::PDF_FILE_NAME_DATE_SIZE + constants::regex::PDF_FILE_NAME_SUFFIX.size()) {
+        return false;
+    }
+    uint32_t digits[constants::regex::PDF_FILE_NAME_DATE_SIZE];
+    for (size_t i = 0; i < constants::regex::PDF_FILE_NAME_DATE_SIZE; ++i) {
+        if (fileName[i] < '0' || fileName[i] > '9') {
+            return false;
+        }
+        digits[i] = static_cast<uint32_t>(fileName[i] - '0');
+    }
+    if (fileName.substr(constants::regex::PDF_FILE_NAME_DATE_SIZE) != constants::regex::PDF_FILE_NAME_SUFFIX) {
+        return false;
+    }
+
+    const uint32_t month = digits[0] * 10 + digits[1];
+    const uint32_t day = digits[2] * 10 + digits[3];
+    const uint32_t year = 2000 + digits[4] * 10 + digits[5];
+    statementDate = year * 10000 + month * 100 + day;
+    return true;
+}
+
+PdfProcessor::PdfProcessor(const std::string pOutputDirectory)
+    : outputDirectory(pOutputDirectory),
+      skippedFiles(outputDirectory + "/" + constants::SKIPPED_FILES_FILE_NAME),
+      skippedLines(outputDirectory + "/" + constants::SKIPPED_LINES_FILE_NAME) {}
+
+std::string_view PdfProcessor::trim(const std::string_view str) {
+    LOG_TRACE("Trimming:", str, "\n");
+    const size_t leading = str.find_first_not_of(" \t\n\r");
+    if (leading == std::string_view::npos) {
+        return std::string_view();
     }
-    size_t end = str.find_last_not_of(" \t\n\r");
-    return (end == std::string::npos) ? "" : result.substr(0, end + 1);
+    const size_t end = str.find_last_not_of(" \t\n\r");
+    return str.substr(leading, end - leading + 1);
 }
 
 /**
- * Uses std::filesystem to iterate through the files in the path provided. If it matches the regex pattern for
+ * Uses std::filesystem to iterate through the files in the paths provided. If it matches the file name pattern for
  * PDF files, it will save the file name for further processing. Otherwise, it won't add it, and instead will
- * add the file name to the file that holds the list of skipped files.
+ * add the file name to the file that holds the list of skipped files. With recursion, subdirectories are looked through
+ * instead of being skipped, and skipped files are listed relative to the directory they were found in.
+ * 
+ * The date of each statement is taken from its file name as it is matched, and the statements are ordered by it, so the
+ * transactions of older statements come first. Statements with the same date are ordered by path, so the order doesn't
+ * depend on the order the files are listed in.
  */
-void PdfProcessor::gatherPdfFiles(const std::string path) {
-    LOG("Gathering PDF files from directory: ", path, "\n");
+void PdfProcessor::gatherPdfFiles(const std::vector<std::string>& paths) {
+    LOG_INFO("Gathering PDF files from ", paths.size(), " directories\n");
+    ScopedTimer timer(getTimer(statistics.gatherTime));
+    TraceSpan span(tracer.get(), "gather");
 
-    if (!std::filesystem::exists(path)) {
-        LOG(path, " doesnt exist\n");
-        throw Exception(path + " doesn't exist");
+    for (const auto& path : paths) {
+        if (!std::filesystem::exists(path)) {
+            LOG_ERROR(path, " doesnt exist\n");
+            throw Exception(path + " doesn't exist");
+        }
     }
 
-    const std::string SKIPPED_FILE_PATH = "./" + constants::OUTPUT_DIRECTORY + "/" + constants::SKIPPED_FILES_FILE_NAME;
-    LOG("Skipped files will be written to ", SKIPPED_FILE_PATH, ". Creating that file.\n");
-    if (!skippedFiles) {
-        LOG("Could not open ", SKIPPED_FILE_PATH, " exiting\n");
+    const std::string SKIPPED_FILE_PATH = outputDirectory + "/" + constants::SKIPPED_FILES_FILE_NAME;
+    LOG_INFO("Skipped files will be written to ", SKIPPED_FILE_PATH, ". Creating that file.\n");
+    if (!skippedFiles.open()) {
+        LOG_ERROR("Could not open ", SKIPPED_FILE_PATH, " exiting\n");
         throw Exception("Could not open " + SKIPPED_FILE_PATH);
     }
 
-    // Go through the files in the directory and add it to the list if it is a .pdf file.
-    // Otherwise, add it to the skipped files.
-    LOG("Looking through files in ", path, "\n");
-    skippedFiles << "-- SKIPPED FILES --\n";
+    // Go through the files in the directories and add them to the list if they are .pdf files.
+    // Otherwise, add them to the skipped files.
+    std::string skippedFileNames = "-- SKIPPED FILES --\n"; /**< Written as one batch once the directories have been listed */
+    std::vector<std::pair<uint32_t, std::string>> statements; /**< The date and path of each statement */
     std::string fileName;
-    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+    const auto addEntry = [&](const std::filesystem::directory_entry& entry, const std::string& path) {
         fileName = entry.path().filename().string();
-        LOG("Processing file ", fileName, "\n");
-        if (std::regex_match(fileName, constants::regex::pdfFilePattern)) {
-            LOG("File ", fileName, " matched the pattern. Adding it to the list for further processing\n");
-            pdfFiles.push_back(entry.path().string());
+        LOG_DEBUG("Processing file ", fileName, "\n");
+        uint32_t statementDate = 0;
+        if (parsePdfFileName(fileName, statementDate)) {
+            LOG_DEBUG("File ", fileName, " matched the pattern. Adding it to the list for further processing\n");
+            statements.emplace_back(statementDate, entry.path().string());
         }
         else {
-            LOG("File ", fileName, " didn't match the pattern. Not adding to to the list, instead adding it to skipped files\n");
-            skippedFiles << fileName << "\n";
+            LOG_DEBUG("File ", fileName, " didn't match the pattern. Not adding to to the list, instead adding it to skipped files\n");
+            skippedFileNames += recursive ? entry.path().lexically_relative(path).string() : fileName;
+            skippedFileNames += '\n';
+        }
+    };
+    for (const auto& path : paths) {
+        LOG_INFO("Looking through files in ", path, recursive ? " and its subdirectories\n" : "\n");
+        if (!recursive) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                addEntry(entry, path);
+            }
+            continue;
+        }
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+            if (!entry.is_directory()) {
+                addEntry(entry, path);
+            }
         }
     }
 
-    skippedFiles << "\n";
+    std::sort(statements.begin(), statements.end());
+    pdfFiles.reserve(pdfFiles.size() + statements.size());
+    for (auto& statement : statements) {
+        pdfFiles.push_back(std::move(statement.second));
+    }
+
+    skippedFileNames += '\n';
+    skippedFiles.write(std::move(skippedFileNames));
     skippedFiles.close();
 
-    LOG("Finished gathering PDF files\n");
+    LOG_INFO("Finished gathering PDF files\n");
 }
 
 
 /**
- * Iterates through the files that were gathered in previous steps. It uses the Poppler library to parse through the PDF statements line-by-line.
- * It uses regex pattern matching to determine if a line is a transaction that needs to be saved. When it encounters a valid transaction, it'll
- * save it internally.
+ * Iterates through the files that were gathered in previous steps and merges their transactions into the internal ones.
  */
-void PdfProcessor::processPdfs(const std::string path) {
-    LOG("Processing PDFs in\"", path, "\"\n");
+void PdfProcessor::processPdfs([[maybe_unused]] const std::string path) {
+    LOG_INFO("Processing PDFs in\"", path, "\"\n");
+    ScopedTimer timer(getTimer(statistics.processTime));
 
-    const std::string skippedLinesPath = "./" + constants::OUTPUT_DIRECTORY + "/" + constants::SKIPPED_LINES_FILE_NAME;
-    if (!skippedLines) {
-        LOG("Could not open ", skippedLinesPath, " exiting\n");
+    const std::string skippedLinesPath = outputDirectory + "/" + constants::SKIPPED_LINES_FILE_NAME;
+    if (!skippedLines.open()) {
+        LOG_ERROR("Could not open ", skippedLinesPath, " exiting\n");
         throw Exception("Could not open " + skippedLinesPath);
     }
-    skippedLines << "-- SKIPPED LINES --\n";
+    skippedLines.write("-- SKIPPED LINES --\n");
 
-    // Parse the list of pdf files, extract the transaction data, and save it in a list
-    for (const auto& file : pdfFiles) {
-        LOG("Processing file: ", file, "\n");
-
-        // Get date from file name
-        const size_t slashIndex = file.find("\\");
-        const std::string month = file.substr(slashIndex + 1, 2);
-        const std::string day = file.substr(slashIndex + 3, 2);
-        const std::string year = "20" + file.substr(slashIndex + 5, 2);
-        const bool isJanuaryStatement = month == "01";
-
-        // Load pdf doc via poppler
-        poppler::document* doc = poppler::document::load_from_file(file);
-        if (!doc) {
-            LOG("Error: Could not open PDF file ", file, ". Exiting\n");
-            throw Exception("Error: Could not open PDF file " + file);
+    processFiles(pdfFiles, skippedLines);
+}
+
+/**
+ * Files that don't match the file name pattern are added to the end of the skipped files file, and files that were already
+ * processed are ignored. The new statements are processed just like processPdfs() does, and become runs of their own
+ * after the sorted transactions, which are then merged. New statements are usually newer than everything else, in which
+ * case they simply stay at the end and the CSV file can be appended to.
+ */
+void PdfProcessor::processNewPdfs(const std::vector<std::string>& files) {
+    LOG_INFO("Processing ", files.size(), " new files\n");
+    ScopedTimer timer(getTimer(statistics.processTime));
+
+    std::vector<std::pair<uint32_t, std::string>> newStatements; /**< The date and path of each new statement */
+    std::string skippedFileNames;
+    for (const auto& file : files) {
+        const std::string fileName = std::filesystem::path(file).filename().string();
+        uint32_t statementDate = 0;
+        if (!parsePdfFileName(fileName, statementDate)) {
+            LOG_DEBUG("File ", fileName, " didn't match the pattern. Adding it to skipped files\n");
+            skippedFileNames += fileName;
+            skippedFileNames += '\n';
+        }
+        else if (std::find(pdfFiles.begin(), pdfFiles.end(), file) != pdfFiles.end()) {
+            LOG_DEBUG("File ", fileName, " was already processed\n");
         }
         else {
-            LOG("Opened pdf file ", file, " successfully\n");
-        }
-
-        // Iterate through the pages of the statement
-        const int numPages = doc->pages();
-        size_t transactionTitleCount = 0; /**< Count the number of times the transaction title is seen because we want to skip the title that's in the header of the statement*/
-        bool lastFourFound = false;
-        std::string lastFour;
-        LOG("Going through ", numPages, " pages\n");
-        LOG("Looking for \"", constants::regex::TRANSACTION_SECTION_TITLE, "\" first\n");
-        for (int i = 0; i < numPages; ++i) {
-            LOG("Processing page ", i, "\n");
-            poppler::page* currentPage = doc->create_page(i);
-            if (currentPage) {
-                LOG("Successfully opened page with poppler.\n");
-
-                // Extract text from the current page
-                std::vector<char> byte_array = currentPage->text().to_utf8();
-                std::stringstream text;
-                text.write(byte_array.data(), byte_array.size());
-                std::string line;
-
-                // Go through line by line
-                while (std::getline(text, line)) {
-                    LOG("Processing line: ", line,  "\n");
-
-                    // Extract last four
-                    if (!lastFourFound) {
-                        if (std::regex_search(line, constants::regex::lastFourPattern)) {
-                            LOG("Line matched last four pattern. Extracting last four\n");
-                            lastFour = line.substr(line.rfind(' ') + 1, 4);
-                            LOG("Extracted last four value: ", lastFour, "\n");
-                            lastFourFound = true;
-                            continue;
-                        }
-                    }
+            newStatements.emplace_back(statementDate, file);
+        }
+    }
+
+    // Ordered the same way as gatherPdfFiles() does
+    std::sort(newStatements.begin(), newStatements.end());
+    std::vector<std::string> newPdfFiles;
+    for (auto& statement : newStatements) {
+        newPdfFiles.push_back(std::move(statement.second));
+    }
+    if (!skippedFileNames.empty()) {
+        ReportWriter report(outputDirectory + "/" + constants::SKIPPED_FILES_FILE_NAME, true);
+        report.write(std::move(skippedFileNames));
+    }
+    if (newPdfFiles.empty()) {
+        return;
+    }
 
-                    /* Before processing anything, find the second instance of the transaction title. This is because transactions come
-                     after this title and we don't want to parse things that come before like credits.
-                     Skip the 1st instance as that's in the document header/summary */
-                    if (transactionTitleCount < 1) {
-                        if (std::regex_search(line, constants::regex::transactionTitlePattern)) {
-                            LOG("Found \"", constants::regex::TRANSACTION_SECTION_TITLE, "\". Parsing transactions now\n");
-                            transactionTitleCount++;
-                        }
+    const size_t oldSize = transactions.size();
+    {
+        ReportWriter report(outputDirectory + "/" + constants::SKIPPED_LINES_FILE_NAME, true);
+        processFiles(newPdfFiles, report);
+    }
+    pdfFiles.insert(pdfFiles.end(), newPdfFiles.begin(), newPdfFiles.end());
+    if (transactions.size() == oldSize) {
+        return;
+    }
 
-                        continue;
-                    }
+    ScopedTimer sortTimer(getTimer(statistics.sortTime));
+    std::vector<size_t> runStarts;
+    if (oldSize > 0) {
+        runStarts.push_back(0); // Already sorted
+    }
+    for (const size_t runStart : transactions.getRunStarts()) {
+        if (runStart >= oldSize) {
+            runStarts.push_back(runStart);
+        }
+    }
 
-                    // Normal transactions
-                    if (std::regex_match(line, constants::regex::transactionPattern)) {
-                        if (!std::regex_search(line, constants::regex::transactionSkip)) {
-                            LOG("Line matched pattern. Saving\n");
-                            Transaction* transaction = new Transaction();
-                            generateTransaction(transaction, line, std::stoi(year), isJanuaryStatement, lastFour, false, false);
-                            transactions.push_back(transaction);
-                        }
-                        else {
-                            LOG("Line matched pattern, but is in the skip list. Skipping and adding to skipped file\n");
-                            skippedLines << trim(line) << "\n";
-                        }
-                    }
-                    // Interest charges
-                    else if (std::regex_match(line, constants::regex::transactionPatternInterest)) {
-                        if (!std::regex_search(line, constants::regex::transactionSkip)) {
-                            LOG("Line matched pattern. It is interest charge. Saving\n");
-                            Transaction* transaction = new Transaction();
-                            generateTransaction(transaction, line, std::stoi(year), isJanuaryStatement, lastFour, false, true);
-                            transactions.push_back(transaction);
-                        }
-                        else {
-                            LOG("Line matched pattern, but is in the skip list. Skipping and adding to skipped file\n");
-                            skippedLines << trim(line) << "\n";
-                        }
-                    }
-                    // Normal transactions that use the old format.
-                    else if (std::regex_match(line, constants::regex::transactionPatternOld)) { 
-                        if (!std::regex_search(line, constants::regex::transactionSkip)) {
-                            LOG("Line matched old pattern. Saving\n");
-                            Transaction* transaction = new Transaction();
-                            generateTransaction(transaction, line, std::stoi(year), isJanuaryStatement, lastFour, true, false);
-                            transactions.push_back(transaction);
-                        }
-                        else {
-                            LOG("Line matched old pattern, but is in the skip list. Skipping and adding to skipped file\n");
-                            skippedLines << trim(line) << "\n";
-                        }
+    // Transactions with the same date as the earliest new one stay in front of it, like a stable sort would keep them
+    const auto byKey = [](const Transaction& first, const Transaction& second) {
+        return first.getDate().getKey() < second.getDate().getKey();
+    };
+    const auto oldEnd = transactions.begin() + oldSize;
+    const Transaction& earliest = *std::min_element(oldEnd, transactions.end(), byKey);
+    const size_t insertIdx = std::upper_bound(transactions.begin(), oldEnd, earliest, byKey) - transactions.begin();
+    unchangedCount = std::min(unchangedCount, insertIdx);
+
+    if (insertIdx < oldSize) {
+        LOG_DEBUG("New transactions go before the end. Merging them in\n");
+    }
+    RunMerge::sort(transactions.getTransactions(), runStarts);
+    transactionIndex.clear();
+}
+
+/**
+ * Each statement is parsed on its own by processPdf(), spread across the worker threads. Every statement collects its
+ * transactions and skipped lines into its own StatementResult, so the workers don't share anything while parsing. The
+ * results are merged in the original file order, which makes the output identical to processing the files one at a time.
+ * Deduplication happens during the merge, so it is the first copy in file order that is kept.
+ * 
+ * A result is merged as soon as every statement before it is done, instead of once all of them are, so the skipped lines
+ * report is written in the background and transactions can be spilled while the rest of the statements are parsed.
+ */
+void PdfProcessor::processFiles(const std::vector<std::string>& files, ReportWriter& report) {
+    // Parse the list of pdf files, extract the transaction data, and save it in a list
+    std::vector<StatementResult> results(files.size());
+    size_t duplicateCount = 0;
+    ThreadPool& threads = getPool();
+    statistics.threadCount = threads.getThreadCount();
+    statistics.pageThreadCount = pageThreadCount;
+    LOG_INFO("Processing ", files.size(), " files with ", threads.getThreadCount(), " threads\n");
+    PdfLoader loader(files, prefetchCount);
+
+    // Statements finish out of order. The finished statements at the front are merged in order as soon as they are done, and
+    // it stops for good at the first statement that failed, just like a serial run would have. With a memory budget, statements
+    // don't start until they are close enough to the front, so finished statements can't pile up.
+    std::mutex finishedMutex;
+    std::condition_variable frontMoved;
+    std::vector<char> finished(files.size(), false);
+    size_t nextToMerge = 0;
+    bool failed = false;
+    const size_t maxAhead = 2 * static_cast<size_t>(threads.getThreadCount());
+    const auto finish = [&](size_t fileIdx) {
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        finished[fileIdx] = true;
+        while (nextToMerge < results.size() && finished[nextToMerge] && !failed) {
+            StatementResult& result = results[nextToMerge];
+            if (result.error) {
+                failed = true;
+                break;
+            }
+            // A merge that fails, ie. a spill to a full disk, fails the statement, so waiting workers are woken up
+            try {
+                report.write(std::move(result.skippedLines));
+
+                const size_t first = transactions.size();
+                transactions.append(std::move(result.transactions));
+                if (deduplication) {
+                    result.statistics.duplicates = deduplicate(first);
+                    duplicateCount += result.statistics.duplicates;
+                }
+                if (memoryBudget > 0 && transactions.getMemoryFootprint() > memoryBudget) {
+                    spillTransactions();
+                }
+            }
+            catch (...) {
+                result.error = std::current_exception();
+                failed = true;
+                break;
+            }
+            if (statisticsEnabled) {
+                statistics.statements.push_back(std::move(result.statistics));
+            }
+            nextToMerge++;
+        }
+        frontMoved.notify_all();
+    };
+
+    threads.parallelFor(files.size(), [&](size_t fileIdx) {
+        if (memoryBudget > 0) {
+            std::unique_lock<std::mutex> lock(finishedMutex);
+            frontMoved.wait(lock, [&] { return fileIdx < nextToMerge + maxAhead || failed; });
+            if (failed) {
+                return; // Nothing after the failed statement is merged
+            }
+        }
+
+        try {
+            TraceSpan span(tracer.get(), "statement", files[fileIdx]);
+            thread_local std::vector<char> data; // Reused for every statement this thread processes
+            {
+                ScopedTimer timer(getTimer(results[fileIdx].statistics.readTime));
+                TraceSpan readSpan(tracer.get(), "read", files[fileIdx]);
+                loader.load(fileIdx, data);
+            }
+            processPdf(files[fileIdx], data, results[fileIdx], threads);
+            span.setCounter("transactions", results[fileIdx].transactions.size());
+        }
+        catch (...) {
+            results[fileIdx].error = std::current_exception();
+        }
+        finish(fileIdx);
+    });
+
+    if (failed) {
+        std::rethrow_exception(results[nextToMerge].error);
+    }
+    if (deduplication) {
+        LOG_INFO("Dropped ", duplicateCount, " duplicate transactions\n");
+    }
+    LOG_INFO("Stored ", transactions.size(), " transactions in ", transactions.getMemoryFootprint(), " bytes\n");
+
+    if (classifierMode == ClassifierMode::Verify) {
+        LOG_INFO("Classifier verification finished with ", LineClassifier::getMismatchCount(), " mismatches\n");
+    }
+}
+
+/**
+ * With the cache enabled, the statement's cache key is computed from its bytes first. If an earlier run already parsed
+ * the same statement, the result is loaded from the cache and Poppler is never involved. Otherwise the statement is parsed
+ * and the result is saved to the cache for the next run.
+ */
+void PdfProcessor::processPdf(const std::string& file, const std::vector<char>& data, StatementResult& result, ThreadPool& threads) {
+    LOG_DEBUG("Processing file: ", file, "\n");
+    result.statistics.file = file;
+
+    if (!cache) {
+        parsePdf(file, data, result, threads);
+        return;
+    }
+
+    bool loaded = false;
+    const uint64_t cacheKey = cache->getKey(file, data, getParseSettings());
+    {
+        ScopedTimer timer(getTimer(result.statistics.loadTime));
+        TraceSpan span(tracer.get(), "load from cache", file);
+        loaded = cache->load(cacheKey, result);
+    }
+    if (loaded) {
+        LOG_DEBUG("Loaded ", file, " from the cache\n");
+        result.statistics.cached = true;
+        result.statistics.matched = result.transactions.size();
+        return;
+    }
+
+    parsePdf(file, data, result, threads);
+    cache->save(cacheKey, result);
+}
+
+/**
+ * The transactions of a statement are one run, which is mostly in date order already, so sorting them is cheap.
+ */
+StatementResult PdfProcessor::convertStatement(const std::string& name, const std::vector<char>& data) {
+    StatementResult result;
+    processPdf(name, data, result, getPool());
+    RunMerge::sort(result.transactions.getTransactions(), result.transactions.getRunStarts());
+    return result;
+}
+
+StatementResult PdfProcessor::convertFile(const std::string& path) {
+    std::vector<char> data;
+    PdfLoader::readFile(path, data);
+    return convertStatement(path, data);
+}
+
+/**
+ * It uses the Poppler library to parse through the PDF statement line-by-line. It uses the LineClassifier to determine
+ * if a line is a transaction that needs to be saved. When it encounters a valid transaction, it'll save it in the result.
+ * 
+ * When page threads are enabled, the pages are split into contiguous chunks that are extracted and classified on the pool.
+ * Each chunk opens its own copy of the document from the same bytes, since Poppler documents shouldn't be shared across threads. The
+ * classified lines are then passed through processLine() in page order, which resolves the state that carries across
+ * pages (the transaction title and the last four) exactly like the one-page-at-a-time path does.
+ * 
+ * Documents and pages are owned by unique_ptrs, so they are freed even if an Exception is thrown. Each page is freed right
+ * after its text is extracted, so only one page per thread is in memory at a time.
+ */
+void PdfProcessor::parsePdf(const std::string& file, const std::vector<char>& data, StatementResult& result, ThreadPool& threads) {
+
+    // Get date from file name
+    uint32_t statementDate = 0;
+    if (!parsePdfFileName(std::filesystem::path(file).filename().string(), statementDate)) {
+        LOG_ERROR("Error: ", file, " isn't named like a statement, so its date is unknown. Exiting\n");
+        throw Exception("Error: " + file + " isn't named like a statement, so its date is unknown");
+    }
+
+    StatementState state;
+    state.year = static_cast<int>(statementDate / 10000);
+    state.isJanuaryStatement = statementDate / 100 % 100 == 1;
+
+    // Load pdf doc via poppler
+    DocumentPtr doc;
+    {
+        ScopedTimer timer(getTimer(result.statistics.loadTime));
+        TraceSpan span(tracer.get(), "load", file);
+        doc.reset(poppler::document::load_from_raw_data(data.data(), static_cast<int>(data.size())));
+    }
+    if (!doc) {
+        LOG_ERROR("Error: Could not open PDF file ", file, ". Exiting\n");
+        throw Exception("Error: Could not open PDF file " + file);
+    }
+    else {
+        LOG_DEBUG("Opened pdf file ", file, " successfully\n");
+    }
+
+    // Iterate through the pages of the statement
+    const int numPages = doc->pages();
+    result.statistics.pages = numPages;
+    LOG_DEBUG("Going through ", numPages, " pages\n");
+    LOG_DEBUG("Looking for \"", constants::regex::TRANSACTION_SECTION_TITLE, "\" first\n");
+
+    const int chunkCount = std::min<int>(numPages, pageThreadCount);
+    if (chunkCount > 1) {
+        LOG_DEBUG("Splitting ", numPages, " pages into ", chunkCount, " chunks\n");
+        std::vector<std::vector<ClassifiedPage>> chunks(chunkCount); /**< The classified pages of each chunk */
+        std::vector<StatementStatistics> chunkStatistics(chunkCount);
+        threads.parallelFor(chunkCount, [&](size_t chunkIdx) {
+            const int firstPage = static_cast<int>(chunkIdx * numPages / chunkCount);
+            const int lastPage = static_cast<int>((chunkIdx + 1) * numPages / chunkCount);
+            StatementStatistics& chunkStats = chunkStatistics[chunkIdx];
+
+            // The first chunk uses the document that is already open
+            DocumentPtr ownDoc;
+            const poppler::document* chunkDoc = doc.get();
+            if (chunkIdx != 0) {
+                ScopedTimer timer(getTimer(chunkStats.loadTime));
+                TraceSpan span(tracer.get(), "load", file);
+                ownDoc.reset(poppler::document::load_from_raw_data(data.data(), static_cast<int>(data.size())));
+                chunkDoc = ownDoc.get();
+            }
+            if (!chunkDoc) {
+                LOG_ERROR("Error: Could not open PDF file ", file, ". Exiting\n");
+                throw Exception("Error: Could not open PDF file " + file);
+            }
+
+            std::vector<ClassifiedPage>& pages = chunks[chunkIdx];
+            pages.resize(lastPage - firstPage);
+            for (int i = firstPage; i < lastPage; ++i) {
+                LOG_TRACE("Processing page ", i, "\n");
+                ClassifiedPage& page = pages[i - firstPage];
+                {
+                    ScopedTimer timer(getTimer(chunkStats.extractTime));
+                    TraceSpan span(tracer.get(), "extract", file, i);
+                    const PagePtr currentPage(chunkDoc->create_page(i));
+                    if (!currentPage) {
+                        LOG_ERROR("Error: Could not load page with poppler. Exiting.\n");
+                        throw Exception("Could not load page with poppler");
                     }
-                    // Skipped, but possibly relevant lines
-                    else if (std::regex_search(line, constants::regex::transactionPatternSkippedRelevant)){
-                        LOG("Line didn't match, but is possibly relevant. Skipping and adding to skipped file\n");
-                        skippedLines << trim(line) << "\n";
+                    page.text = currentPage->text(toRect(textRegion)).to_utf8();
+                }
+                chunkStats.textBytes += page.text.size();
+
+                ScopedTimer timer(getTimer(chunkStats.classifyTime));
+                TraceSpan span(tracer.get(), "classify", file, i);
+                const std::string_view text(page.text.data(), page.text.size());
+                if (canSkipPage(nullptr, text)) {
+                    LOG_TRACE("Skipping page ", i, " since none of its lines can matter\n");
+                    chunkStats.prunedPages++;
+                    page.prunedLines = countLines(text);
+                    span.setCounter("pruned", 1);
+                    continue;
+                }
+                LineReader lines(text);
+                std::string_view line;
+                while (lines.next(line)) {
+                    page.lines.push_back(classifyLine(line));
+                }
+                if (span.isEnabled()) {
+                    setKindCounters(span, page.lines);
+                }
+            }
+        });
+
+        for (const auto& chunkStats : chunkStatistics) {
+            result.statistics.add(chunkStats);
+        }
+
+        // Ordered reduction over the classified pages. Like the serial path, it stops counting lines once the section ends
+        TraceSpan span(tracer.get(), "generate", file);
+        for (const auto& pages : chunks) {
+            for (const auto& page : pages) {
+                result.statistics.lines += page.prunedLines;
+                for (const auto& line : page.lines) {
+                    processLine(state, line.text, &line, result);
+                    if (state.sectionEnded) {
+                        break;
                     }
                 }
-            } else {
-                LOG("Error: Could not load page with poppler. Exiting.\n");
+                if (state.sectionEnded) {
+                    break;
+                }
+            }
+            if (state.sectionEnded) {
+                LOG_DEBUG("Stopping since the transaction section ended\n");
+                break;
+            }
+        }
+        span.setCounter("transactions", result.statistics.matched);
+        return;
+    }
+
+    std::vector<char> byte_array;
+    for (int i = 0; i < numPages; ++i) {
+        LOG_TRACE("Processing page ", i, "\n");
+        {
+            ScopedTimer timer(getTimer(result.statistics.extractTime));
+            TraceSpan span(tracer.get(), "extract", file, i);
+            const PagePtr currentPage(doc->create_page(i));
+            if (!currentPage) {
+                LOG_ERROR("Error: Could not load page with poppler. Exiting.\n");
                 throw Exception("Could not load page with poppler");
             }
+            LOG_TRACE("Successfully opened page with poppler.\n");
+
+            // Extract text from the current page
+            byte_array = currentPage->text(toRect(textRegion)).to_utf8();
+        }
+        result.statistics.textBytes += byte_array.size();
+
+        // Classification and generation are interleaved line by line, so they share a span
+        TraceSpan span(tracer.get(), "classify and generate", file, i);
+        const std::string_view text(byte_array.data(), byte_array.size());
+        if (canSkipPage(&state, text)) {
+            LOG_TRACE("Skipping page ", i, " since none of its lines can matter\n");
+            result.statistics.prunedPages++;
+            result.statistics.lines += countLines(text);
+            span.setCounter("pruned", 1);
+            continue;
+        }
+
+        // Go through line by line
+        const StatementStatistics before = span.isEnabled() ? result.statistics : StatementStatistics();
+        LineReader lines(text);
+        std::string_view line;
+        while (!state.sectionEnded && lines.next(line)) {
+            processLine(state, line, nullptr, result);
         }
-        delete doc;
+        if (span.isEnabled()) {
+            span.setCounter("lines", result.statistics.lines - before.lines);
+            span.setCounter("transactions", result.statistics.matched - before.matched);
+            span.setCounter("skipListed", result.statistics.skipped - before.skipped);
+            span.setCounter("possiblyRelevant", result.statistics.possiblyRelevant - before.possiblyRelevant);
+        }
+        if (state.sectionEnded) {
+            LOG_DEBUG("Stopping after page ", i, " since the transaction section ended\n");
+            break;
+        }
+    }
+}
+
+/**
+ * Page pruning is left out since it never changes the result.
+ */
+std::string PdfProcessor::getParseSettings() const {
+    if (!stopAtSectionEnd && textRegion.isEmpty()) {
+        return std::string();
+    }
+    std::ostringstream settings;
+    settings << "stop=" << stopAtSectionEnd << ";region=" << textRegion.x << "," << textRegion.y << "," << textRegion.width << "," << textRegion.height;
+    return settings.str();
+}
+
+/**
+ * Without a state, the page is only skipped if it can't matter no matter what came before it. A page with the end of the
+ * transaction section is never skipped when stopping there, since it decides whether the pages after it are read.
+ */
+bool PdfProcessor::canSkipPage(const StatementState* state, const std::string_view text) const {
+    if (!pagePruning) {
+        return false;
+    }
+
+    const PageFeatures features = LineClassifier::scanPage(text);
+    if (features.hasLastFour && (!state || !state->lastFourFound)) {
+        return false;
+    }
+    if (stopAtSectionEnd && features.hasSectionEnd) {
+        return false;
     }
+    if (!state) {
+        return !features.hasTitle && !features.hasRelevant;
+    }
+    // Only the title matters before the transaction section, and only possible transactions matter inside it
+    return (state->transactionTitleCount < 1) ? !features.hasTitle : !features.hasRelevant;
+}
+
+PdfProcessor::ClassifiedLine PdfProcessor::classifyLine(const std::string_view line) {
+    ClassifiedLine classified;
+    classified.text = line;
+    classified.isLastFour = LineClassifier::isLastFourLine(line, classifierMode);
+    classified.isTitle = LineClassifier::isTitleLine(line, classifierMode);
+    classified.match = LineClassifier::classify(line, classifierMode);
+    return classified;
+}
+
+void PdfProcessor::processLine(StatementState& state, const std::string_view line, const ClassifiedLine* classified, StatementResult& result) {
+    LOG_TRACE("Processing line: ", line,  "\n");
+    ++result.statistics.lines;
+    if (state.sectionEnded) {
+        return;
+    }
+
+    // Lines that were classified on a page thread were already timed there
+    std::chrono::nanoseconds* classifyTimer = classified ? nullptr : getTimer(result.statistics.classifyTime);
+
+    // Extract last four
+    if (!state.lastFourFound) {
+        bool isLastFour = false;
+        {
+            ScopedTimer timer(classifyTimer);
+            isLastFour = classified ? classified->isLastFour : LineClassifier::isLastFourLine(line, classifierMode);
+        }
+        if (isLastFour) {
+            LOG_DEBUG("Line matched last four pattern. Extracting last four\n");
+            state.lastFour = line.substr(line.rfind(' ') + 1, 4);
+            LOG_DEBUG("Extracted last four value: ", state.lastFour, "\n");
+            state.lastFourFound = true;
+            return;
+        }
+    }
+
+    /* Before processing anything, find the second instance of the transaction title. This is because transactions come
+     after this title and we don't want to parse things that come before like credits.
+     Skip the 1st instance as that's in the document header/summary */
+    if (state.transactionTitleCount < 1) {
+        bool isTitle = false;
+        {
+            ScopedTimer timer(classifyTimer);
+            isTitle = classified ? classified->isTitle : LineClassifier::isTitleLine(line, classifierMode);
+        }
+        if (isTitle) {
+            LOG_DEBUG("Found \"", constants::regex::TRANSACTION_SECTION_TITLE, "\". Parsing transactions now\n");
+            state.transactionTitleCount++;
+        }
+
+        return;
+    }
+
+    if (stopAtSectionEnd && line.find(constants::regex::TRANSACTION_SECTION_END) != std::string_view::npos) {
+        LOG_DEBUG("Found \"", constants::regex::TRANSACTION_SECTION_END, "\". Ignoring the rest of the statement\n");
+        state.sectionEnded = true;
+        return;
+    }
+
+    LineMatch match;
+    {
+        ScopedTimer timer(classifyTimer);
+        match = classified ? classified->match : LineClassifier::classify(line, classifierMode);
+    }
+    const LineKind kind = match.kind;
+    switch (kind) {
+        case LineKind::Transaction:
+        case LineKind::TransactionInterest:
+        case LineKind::TransactionOld: {
+            if (kind == LineKind::Transaction) {
+                LOG_TRACE("Line matched pattern. Saving\n");
+            }
+            else if (kind == LineKind::TransactionInterest) {
+                LOG_TRACE("Line matched pattern. It is interest charge. Saving\n");
+            }
+            else {
+                LOG_TRACE("Line matched old pattern. Saving\n");
+            }
+            ScopedTimer timer(getTimer(result.statistics.generateTime));
+            Transaction& transaction = result.transactions.add();
+            generateTransaction(&transaction, line, match, state.year, state.isJanuaryStatement, state.lastFour, result.transactions);
+            ++result.statistics.matched;
+            break;
+        }
+        case LineKind::SkipListed:
+            LOG_TRACE("Line matched pattern, but is in the skip list. Skipping and adding to skipped file\n");
+            result.skippedLines += trim(line);
+            result.skippedLines += '\n';
+            ++result.statistics.skipped;
+            break;
+        case LineKind::SkippedRelevant:
+            LOG_TRACE("Line didn't match, but is possibly relevant. Skipping and adding to skipped file\n");
+            result.skippedLines += trim(line);
+            result.skippedLines += '\n';
+            ++result.statistics.possiblyRelevant;
+            break;
+        case LineKind::Irrelevant:
+            break;
+    }
+}
+
+void PdfProcessor::setThreadCount(const unsigned int pThreadCount) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    threadCount = (pThreadCount == 0) ? 1 : pThreadCount;
+    if (pool && pool->getThreadCount() != threadCount) {
+        pool.reset();
+    }
+}
+
+void PdfProcessor::setPageThreadCount(const unsigned int pPageThreadCount) {
+    pageThreadCount = (pPageThreadCount == 0) ? 1 : pPageThreadCount;
+}
+
+void PdfProcessor::setClassifierMode(const ClassifierMode pClassifierMode) {
+    classifierMode = pClassifierMode;
+}
+
+void PdfProcessor::setCacheEnabled(const bool enabled) {
+    if (!enabled) {
+        cache.reset();
+    }
+    else if (!cache) {
+        cache = std::make_unique<StatementCache>(outputDirectory + "/" + constants::CACHE_DIRECTORY);
+    }
+}
+
+void PdfProcessor::setDeduplication(const bool enabled) {
+    deduplication = enabled;
+}
+
+void PdfProcessor::setSummaryEnabled(const bool enabled) {
+    summaryEnabled = enabled;
+}
+
+void PdfProcessor::setRecursive(const bool enabled) {
+    recursive = enabled;
+}
+
+void PdfProcessor::setAccountFilesEnabled(const bool enabled) {
+    accountFilesEnabled = enabled;
+}
+
+void PdfProcessor::setCombinedFileEnabled(const bool enabled) {
+    combinedFileEnabled = enabled;
+}
+
+void PdfProcessor::setColumnarEnabled(const bool enabled) {
+    columnarEnabled = enabled;
+}
+
+void PdfProcessor::setMemoryBudget(const size_t budget) {
+    memoryBudget = budget;
+    if (memoryBudget == 0) {
+        externalMerge.reset();
+    }
+    else if (!externalMerge) {
+        externalMerge = std::make_unique<ExternalMerge>(outputDirectory);
+    }
+}
+
+void PdfProcessor::setPrefetchCount(const unsigned int pPrefetchCount) {
+    prefetchCount = pPrefetchCount;
+}
+
+void PdfProcessor::setPagePruning(const bool enabled) {
+    pagePruning = enabled;
+}
+
+void PdfProcessor::setStopAtSectionEnd(const bool enabled) {
+    stopAtSectionEnd = enabled;
+}
+
+void PdfProcessor::setTextRegion(const TextRegion& region) {
+    textRegion = region;
+}
+
+void PdfProcessor::setStatisticsEnabled(const bool enabled) {
+    statisticsEnabled = enabled;
 }
 
 void PdfProcessor::closeSkippedFilesFile() {
@@ -218,113 +822,402 @@ void PdfProcessor::closeSkippedLinesFile() {
 
 /**
  * For the values that it already knows/was passed into the function, it will simply populate the Transaction object with those values.
- * For the values that it doesn't know, it'll extract the values from the line that was passed in by searching the line for various characters
- * and using the indicies of those characters to extract substrings that have the desired value. There is special handling for January statements
+ * For the values that it doesn't know, it'll read them straight out of the line, using the field positions that the LineClassifier found.
+ * Nothing is copied out of the line until the values are handed to the Transaction. There is special handling for January statements
  * with December transactions. In those cases, the year value is decreased by one, because even though the statement is from one year, the
  * transaction occured the year before.
  */
-void PdfProcessor::generateTransaction(Transaction* transaction, std::string line, int year, const bool isJanuaryStatement, const std::string lastFour, const bool isOldFormat, const bool isInterestCharge) {
-    LOG("Generating transaction\n");
+void PdfProcessor::generateTransaction(Transaction* transaction, const std::string_view line, const LineMatch& match, int year, const bool isJanuaryStatement, const std::string& lastFour, TransactionStore& store) {
+    LOG_TRACE("Generating transaction\n");
 
     if (!transaction) {
         throw Exception("Null transaction address passed to generateTransaction");
     }
+    const bool isInterestCharge = match.kind == LineKind::TransactionInterest;
 
     // Last four of account number
-    LOG("Setting Last Four to: ", lastFour, "\n");
+    LOG_TRACE("Setting Last Four to: ", lastFour, "\n");
     transaction->setLastFour(lastFour);
-    if (!isOldFormat && !isInterestCharge) { // If new format, then remove last four from line. Old format doesn't have last four.
-        const size_t lastFourIdx = line.find_first_not_of(" \t");
-        line = line.substr(lastFourIdx + 4); 
-    }
 
-    // Date
-    LOG("Getting date\n");
-    const size_t dateIdx = line.find("/");
-    const int month = std::stoi(line.substr(dateIdx - 2, 2));
-    const int day = std::stoi(line.substr(dateIdx + 1, 2));
+    // Date. The classifier already checked that it is in the form "MM/DD".
+    LOG_TRACE("Getting date\n");
+    const std::string_view dateStr = line.substr(match.transactionDate.offset, match.transactionDate.length);
+    const int month = (dateStr[0] - '0') * 10 + (dateStr[1] - '0');
+    const int day = (dateStr[3] - '0') * 10 + (dateStr[4] - '0');
     const bool isDecemberTransaction = month == 12;
     // Special handling if it's a January statement and a December transaction. Decrement year by 1, since the transaction occured the year before.
     if (isJanuaryStatement && isDecemberTransaction) {
-        LOG("It is a Jan statement and a Dec transaction. Decrementing year by 1\n");
+        LOG_TRACE("It is a Jan statement and a Dec transaction. Decrementing year by 1\n");
         year--;
     }
     Date date(year, month, day);
-    LOG("Setting date to ", date.getDateString(), "\n");
+    LOG_TRACE("Setting date to ", date.getDateString(), "\n");
     transaction->setDate(date);
-    line = line.substr(line.find("/", dateIdx + 1) + 3); // Remove date from line
 
     // Reference number
+    size_t nameIdx = match.postDate.offset + match.postDate.length;
     if (!isInterestCharge) { // Skip retrieving ref num for interest charge as they don't have it
-        LOG("Getting reference number\n");
-        const size_t refNumIdx = line.find_first_not_of(" ");
-        const std::string refNum = line.substr(refNumIdx, constants::REF_NUM_SIZE); // The length of a reference number is known, so use that value here.
-        LOG("Setting reference number to ", refNum, "\n");
+        LOG_TRACE("Getting reference number\n");
+        const size_t refNumIdx = match.referenceNum.offset;
+        const size_t refNumEndIdx = std::min(refNumIdx + constants::REF_NUM_SIZE, match.amount.offset); // The length of a reference number is known, so use that value here.
+        const std::string_view refNum = line.substr(refNumIdx, refNumEndIdx - refNumIdx);
+        LOG_TRACE("Setting reference number to ", refNum, "\n");
         transaction->setRefNum(refNum);
-        line = line.substr(refNumIdx + constants::REF_NUM_SIZE);
-    }
-    
-    // Amount (currency)
-    LOG("Getting amount\n");
-    line = trim(line);
-    const size_t amountIdx = line.rfind(' ') + 1;
-    std::string amountStr = line.substr(amountIdx);
-    amountStr.erase(std::remove(amountStr.begin(), amountStr.end(), ','), amountStr.end()); // Remove comma
-    const double amount = std::stod(amountStr);
-    LOG("Setting amount to ", amount, "\n");
+        nameIdx = refNumEndIdx;
+    }
+
+    // Amount (currency), in cents
+    LOG_TRACE("Getting amount\n");
+    const std::string_view amountStr = line.substr(match.amount.offset, match.amount.length);
+    int64_t amount = 0;
+    if (!Transaction::parseAmount(amountStr, amount)) {
+        LOG_ERROR("Couldn't parse the amount \"", amountStr, "\"\n");
+        throw Exception("Couldn't parse the amount \"" + std::string(amountStr) + "\"");
+    }
+    LOG_TRACE("Setting amount to ", amount, "\n");
     transaction->setAmount(amount);
-    line = line.substr(0, amountIdx - 1); // Remove amount from line
 
-    // Name of transaction
-    LOG("Getting name\n");
-    const size_t nameEndIdx = line.find_last_not_of(" \t\n\r");
-    const std::string name = line.substr(0, nameEndIdx + 1);
-    LOG("Setting name to ", name, "\n");
-    transaction->setName(name);
+    // Name of transaction. It's everything between the reference number (or the dates) and the amount.
+    LOG_TRACE("Getting name\n");
+    const std::string_view name = (nameIdx < match.amount.offset) ? trim(line.substr(nameIdx, match.amount.offset - nameIdx)) : std::string_view();
+    LOG_TRACE("Setting name to ", name, "\n");
+    transaction->setName(store.storeName(name));
 
-    LOG("Created transaction: ", transaction->getCsvFormat(), "\n");
+    LOG_TRACE("Created transaction: ", transaction->getCsvFormat(), "\n");
 }
 
 /**
- * Calls an external sorting algorithm to sort the data. Sorts the data in-place, doesn't make or return a copy.
+ * Calls an external sorting algorithm to sort the data by date. Each statement's transactions were stored as a separate run,
+ * and statements list their transactions mostly in date order, so the runs are merged rather than sorting everything from
+ * scratch. The sort is stable, so transactions on the same date stay in the order they were found in, and the output is the
+ * same from run to run.
  */
 void PdfProcessor::sortTransactions() {
-    LOG("Sorting transactions\n");
-    QuickSort::quickSort(transactions, 0, transactions.size() - 1);
-    LOG("Finished sorting transactions\n");
+    LOG_INFO("Sorting transactions\n");
+    ScopedTimer timer(getTimer(statistics.sortTime));
+    TraceSpan span(tracer.get(), "sort");
+    RunMerge::sort(transactions.getTransactions(), transactions.getRunStarts());
+    transactionIndex.clear();
+    LOG_INFO("Finished sorting transactions\n");
 }
 
 /**
  * If there were no transactions, it'll just create a file with the contents "None".
- * Otherwise, it iterates through the internal transaction data and adds it to a file via std::ofstream.
+ * Otherwise, it adds the internal transaction data to the file with writeCsvRows().
  */
 void PdfProcessor::generateCsvFile(const std::string fileName) {
-    LOG("Generating .csv file called", fileName, "\n");
+    LOG_INFO("Generating .csv file called", fileName, "\n");
+    ScopedTimer timer(getTimer(statistics.csvTime));
+    TraceSpan span(tracer.get(), "generate csv", fileName);
 
-    std::ofstream csvFile("./" + constants::OUTPUT_DIRECTORY + "/" + fileName);
-    if (!csvFile) {
-        LOG("Couldn't open ", fileName, "\n");
-        throw Exception("Couldn't open " + fileName);
+    summary.clear();
+    if (externalMerge && externalMerge->getRunCount() > 0) {
+        CsvWriter csvFile(outputDirectory + "/" + fileName);
+        std::unique_ptr<ColumnarWriter> columnarFile;
+        if (columnarEnabled) {
+            columnarFile = std::make_unique<ColumnarWriter>(getColumnarPath(fileName));
+        }
+        mergeSpilledTransactions(csvFile, columnarFile.get());
+        return;
+    }
+    if (columnarEnabled) {
+        generateColumnarFile(fileName);
+    }
+    if (accountFilesEnabled) {
+        generateAccountFiles();
+    }
+    if (!combinedFileEnabled) {
+        LOG_INFO("Not writing ", fileName, " since the combined file is turned off\n");
+        if (summaryEnabled) {
+            for (const auto& transaction : transactions) {
+                summary.add(transaction);
+            }
+        }
+        csvRowCount = 0;
+        unchangedCount = 0;
+        writeSummary();
+        return;
     }
 
+    CsvWriter csvFile(outputDirectory + "/" + fileName);
     if (transactions.size() == 0) {
-        LOG("None\n");
-        csvFile << "None";
+        LOG_INFO("None\n");
+        csvFile.write("None");
         csvFile.close();
+        csvRowCount = 0;
+        unchangedCount = 0;
+        writeSummary();
         return;
     }
 
-    for (auto& transaction : transactions) {
-        csvFile << transaction->getCsvFormat() << "\n";
+    writeCsvRows(csvFile, 0, transactions.size());
+
+    csvFile.close();
+    csvRowCount = transactions.size();
+    unchangedCount = transactions.size();
+    writeSummary();
+}
+
+void PdfProcessor::mergeSpilledTransactions(CsvWriter& csvFile, ColumnarWriter* columnarFile) {
+    const size_t duplicateCount = externalMerge->merge(transactions.getTransactions(), deduplication, [&](const Transaction& transaction) {
+        csvFile.write(transaction);
+        if (columnarFile) {
+            columnarFile->write(transaction);
+        }
+        if (summaryEnabled) {
+            summary.add(transaction);
+        }
+    });
+    if (deduplication) {
+        LOG_INFO("Dropped ", duplicateCount, " duplicate transactions while merging the spill files\n");
     }
 
     csvFile.close();
+    if (columnarFile) {
+        columnarFile->close();
+    }
+    csvRowCount = 0;
+    unchangedCount = 0;
+    writeSummary();
+}
+
+/**
+ * With more than one thread and enough rows, the rows are split into chunks of CSV_CHUNK_ROWS. A batch of chunks, a few
+ * per thread, is formatted on the pool into separate buffers, which are then written in order. Each buffer is written
+ * in one go, and the buffers are reused by the next batch, so memory use doesn't grow with the number of rows. The
+ * output is the same as formatting the rows one by one.
+ */
+void PdfProcessor::writeCsvRows(CsvWriter& csvFile, const size_t begin, const size_t end) {
+    if (summaryEnabled) {
+        for (size_t i = begin; i < end; ++i) {
+            summary.add(transactions[i]);
+        }
+    }
+
+    ThreadPool& threads = getPool();
+    if (threads.getThreadCount() <= 1 || end - begin < 2 * CSV_CHUNK_ROWS) {
+        for (size_t i = begin; i < end; ++i) {
+            csvFile.write(transactions[i]);
+        }
+        return;
+    }
+
+    std::vector<std::string> chunks(2 * static_cast<size_t>(threads.getThreadCount()));
+    LOG_DEBUG("Formatting ", end - begin, " rows in chunks of ", CSV_CHUNK_ROWS, " on ", threads.getThreadCount(), " threads\n");
+    for (size_t batchBegin = begin; batchBegin < end; batchBegin += chunks.size() * CSV_CHUNK_ROWS) {
+        const size_t chunkCount = std::min(chunks.size(), (end - batchBegin + CSV_CHUNK_ROWS - 1) / CSV_CHUNK_ROWS);
+        threads.parallelFor(chunkCount, [&](size_t chunkIdx) {
+            std::string& chunk = chunks[chunkIdx];
+            chunk.clear();
+            const size_t first = batchBegin + chunkIdx * CSV_CHUNK_ROWS;
+            const size_t last = std::min(end, first + CSV_CHUNK_ROWS);
+            for (size_t i = first; i < last; ++i) {
+                transactions[i].appendCsvFormat(chunk);
+                chunk += '\n';
+            }
+        });
+        for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx) {
+            csvFile.write(chunks[chunkIdx]);
+        }
+    }
+}
+
+/**
+ * The transactions are split into a list of positions per account. The transactions are already sorted, and each list
+ * keeps their order, so every shard comes out sorted without sorting it again. The shards are then written at the same
+ * time on the thread pool, each by its own CsvWriter. The shard directory is emptied first, so accounts that are no longer
+ * in the statements don't leave files behind.
+ */
+void PdfProcessor::generateAccountFiles() {
+    const std::string directory = outputDirectory + "/" + constants::ACCOUNT_DIRECTORY;
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    NameInterner accounts;
+    std::vector<std::vector<uint32_t>> shards; /**< The positions of the transactions of each account */
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        const uint32_t account = accounts.intern(transactions[i].getLastFour());
+        if (account == shards.size()) {
+            shards.emplace_back();
+        }
+        shards[account].push_back(static_cast<uint32_t>(i));
+    }
+
+    LOG_INFO("Writing ", shards.size(), " account files to ", directory, "\n");
+    getPool().parallelFor(shards.size(), [&](size_t account) {
+        CsvWriter accountFile(directory + "/" + getAccountFileName(accounts.getName(static_cast<uint32_t>(account))));
+        for (const uint32_t position : shards[account]) {
+            accountFile.write(transactions[position]);
+        }
+        accountFile.close();
+    });
+}
+
+/**
+ * Last fours are normally digits, which are kept. Anything else is written as '_' and its two hex digits, so different
+ * last fours never share a file, even on file systems that ignore case. Escaped names only have digits, '_' and
+ * uppercase hex digits, so they can't be constants::UNKNOWN_ACCOUNT either.
+ */
+std::string PdfProcessor::getAccountFileName(const std::string_view lastFour) {
+    if (lastFour.empty()) {
+        return constants::UNKNOWN_ACCOUNT + ".csv";
+    }
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    std::string fileName;
+    for (const char c : lastFour) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if (std::isdigit(byte)) {
+            fileName += c;
+        }
+        else {
+            fileName += '_';
+            fileName += HEX_DIGITS[byte >> 4];
+            fileName += HEX_DIGITS[byte & 0xF];
+        }
+    }
+    return fileName + ".csv";
+}
+
+void PdfProcessor::generateColumnarFile(const std::string& fileName) {
+    ColumnarWriter columnarFile(getColumnarPath(fileName));
+    for (const auto& transaction : transactions) {
+        columnarFile.write(transaction);
+    }
+    columnarFile.close();
+}
+
+void PdfProcessor::writeSummary() {
+    if (summaryEnabled) {
+        summary.write(outputDirectory + "/" + constants::SUMMARY_FILE_NAME);
+    }
+}
+
+std::string PdfProcessor::getColumnarPath(const std::string& fileName) const {
+    return outputDirectory + "/" + std::filesystem::path(fileName).replace_extension(constants::COLUMNAR_FILE_EXTENSION).string();
+}
+
+/**
+ * Appending only works if the file already has rows and none of them moved. Otherwise the whole file is written again.
+ * The columnar file can't be appended to, since its columns would move, so it is always written again. The summary
+ * keeps the totals of the rows that are already in the file, so only the new rows are added to it.
+ */
+void PdfProcessor::updateCsvFile(const std::string fileName) {
+    if (csvRowCount == 0 || unchangedCount < csvRowCount) {
+        generateCsvFile(fileName);
+        return;
+    }
+
+    LOG_INFO("Adding ", transactions.size() - csvRowCount, " transactions to the end of ", fileName, "\n");
+    ScopedTimer timer(getTimer(statistics.csvTime));
+    CsvWriter csvFile(outputDirectory + "/" + fileName, true);
+    writeCsvRows(csvFile, csvRowCount, transactions.size());
+    csvFile.close();
+    csvRowCount = transactions.size();
+    unchangedCount = transactions.size();
+    writeSummary();
+
+    if (accountFilesEnabled) {
+        generateAccountFiles();
+    }
+
+    if (columnarEnabled) {
+        generateColumnarFile(fileName);
+    }
 }
 
 void PdfProcessor::printAllTransactions() {
-    LOG("Printing all transactions\n");
-    for (auto transaction : transactions) {
-        LOG(transaction->getCsvFormat(), "\n");
+    LOG_INFO("Printing all transactions\n");
+#if MIN_LOG_LEVEL <= LOG_LEVEL_TRACE
+    for (const auto& transaction : transactions) {
+        LOG_TRACE(transaction.getCsvFormat(), "\n");
+    }
+#endif
+    LOG_INFO("Finished printing all transactions\n");
+}
+
+TransactionStore& PdfProcessor::getTransactions() {
+    return transactions;
+}
+
+void PdfProcessor::writeStatistics(const std::string fileName) {
+    statistics.writeJson(outputDirectory + "/" + fileName);
+}
+
+void PdfProcessor::setTraceEnabled(const bool enabled) {
+    if (!enabled) {
+        tracer.reset();
+    }
+    else if (!tracer) {
+        tracer = std::make_unique<Tracer>();
     }
-    LOG("Finished printing all transactions\n");
+}
+
+void PdfProcessor::writeTrace(const std::string fileName) {
+    if (tracer) {
+        tracer->writeJson(outputDirectory + "/" + fileName);
+    }
+}
+
+/**
+ * Every classified line is counted, including the ones before the transaction section, since the page threads don't
+ * know where it starts.
+ */
+void PdfProcessor::setKindCounters(TraceSpan& span, const std::vector<ClassifiedLine>& lines) {
+    size_t counts[static_cast<size_t>(LineKind::Irrelevant) + 1] = {};
+    for (const auto& line : lines) {
+        counts[static_cast<size_t>(line.match.kind)]++;
+    }
+    span.setCounter("lines", lines.size());
+    span.setCounter("transactions", counts[static_cast<size_t>(LineKind::Transaction)] + counts[static_cast<size_t>(LineKind::TransactionInterest)]
+        + counts[static_cast<size_t>(LineKind::TransactionOld)]);
+    span.setCounter("skipListed", counts[static_cast<size_t>(LineKind::SkipListed)]);
+    span.setCounter("possiblyRelevant", counts[static_cast<size_t>(LineKind::SkippedRelevant)]);
+}
+
+/**
+ * The index only knows where the transactions are until they are sorted. If it was cleared since, it is filled again
+ * with the transactions in front of the position. A statement can have the same transaction twice, ie. two interest
+ * charges of the same amount on the same day, so only the first copy is indexed, and a transaction that is the same as
+ * one from the position on is kept.
+ */
+size_t PdfProcessor::deduplicate(const size_t first) {
+    const std::vector<Transaction>& all = transactions.getTransactions();
+    if (first > 0 && transactionIndex.size() == 0) {
+        for (size_t i = 0; i < first; ++i) {
+            transactionIndex.insert(all, all[i], i);
+        }
+    }
+    return transactions.filter(first, [this, &all, first](const Transaction& transaction, const size_t position) {
+        const size_t same = transactionIndex.find(all, transaction);
+        if (same == TransactionIndex::NOT_FOUND) {
+            transactionIndex.insert(all, transaction, position);
+            return true;
+        }
+        return same >= first;
+    });
+}
+
+/**
+ * The statements become one sorted run. Deduplication only knows about the transactions in memory, so duplicates in
+ * different runs are dropped while the runs are merged instead.
+ */
+void PdfProcessor::spillTransactions() {
+    ScopedTimer timer(getTimer(statistics.sortTime));
+    RunMerge::sort(transactions.getTransactions(), transactions.getRunStarts());
+    externalMerge->spill(transactions.getTransactions());
+    statistics.spillCount++;
+    transactions.clear();
+    transactionIndex.clear();
+}
+
+ThreadPool& PdfProcessor::getPool() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+    return *pool;
+}
+
+std::chrono::nanoseconds* PdfProcessor::getTimer(std::chrono::nanoseconds& duration) const {
+    return statisticsEnabled ? &duration : nullptr;
 }
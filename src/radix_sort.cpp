@@ -0,0 +1,82 @@
+/**
+ * @file radix_sort.cpp
+ * @brief Source file for the Radix Sort class/algorithm.
+ */
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "wells_fargo_statement_converter/radix_sort.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+constexpr unsigned int DIGIT_BITS = 8;
+constexpr unsigned int DIGIT_COUNT = 32 / DIGIT_BITS;
+constexpr size_t BUCKET_COUNT = size_t(1) << DIGIT_BITS;
+
+/**
+ * @brief A date key along with the position of its transaction, so the transactions are only moved once.
+ */
+struct KeyedIndex {
+    uint32_t key;
+    uint32_t index;
+};
+
+} // namespace
+
+/**
+ * Sorts (key, index) pairs instead of the transactions themselves, one byte of the key at a time, starting with the
+ * least significant byte. Each pass is a counting sort, which is stable, so the final order is stable too. The counts
+ * for every byte are collected in a single pass up front, and bytes that are the same for every key (like the high
+ * bytes of the year) are skipped. At the end the transactions are moved into place in one go.
+ */
+void RadixSort::sort(std::vector<Transaction>& vec) {
+    sort(vec.begin(), vec.end());
+}
+
+void RadixSort::sort(const std::vector<Transaction>::iterator first, const std::vector<Transaction>::iterator last) {
+    const size_t size = static_cast<size_t>(last - first);
+    LOG_DEBUG("Radix sorting ", size, " transactions\n");
+    if (size < 2) {
+        return;
+    }
+
+    std::vector<KeyedIndex> keys(size);
+    std::array<std::array<size_t, BUCKET_COUNT>, DIGIT_COUNT> counts{};
+    for (size_t i = 0; i < size; ++i) {
+        const uint32_t key = first[i].getDate().getKey();
+        keys[i] = KeyedIndex{key, static_cast<uint32_t>(i)};
+        for (unsigned int digit = 0; digit < DIGIT_COUNT; ++digit) {
+            counts[digit][(key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1)]++;
+        }
+    }
+
+    std::vector<KeyedIndex> buffer(size);
+    for (unsigned int digit = 0; digit < DIGIT_COUNT; ++digit) {
+        std::array<size_t, BUCKET_COUNT>& count = counts[digit];
+        const unsigned int shift = digit * DIGIT_BITS;
+        if (count[(keys[0].key >> shift) & (BUCKET_COUNT - 1)] == size) {
+            continue; // Every key has the same value for this digit
+        }
+
+        // Turn the counts into the starting position of each bucket
+        size_t position = 0;
+        for (size_t& bucket : count) {
+            const size_t bucketSize = bucket;
+            bucket = position;
+            position += bucketSize;
+        }
+
+        for (const KeyedIndex& keyed : keys) {
+            buffer[count[(keyed.key >> shift) & (BUCKET_COUNT - 1)]++] = keyed;
+        }
+        keys.swap(buffer);
+    }
+
+    std::vector<Transaction> sorted;
+    sorted.reserve(size);
+    for (const KeyedIndex& keyed : keys) {
+        sorted.push_back(first[keyed.index]);
+    }
+    std::copy(sorted.begin(), sorted.end(), first);
+}
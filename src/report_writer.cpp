@@ -0,0 +1,88 @@
+/**
+ * @file report_writer.cpp
+ * @brief Source file for the ReportWriter class.
+ */
+#include <utility>
+#include "wells_fargo_statement_converter/report_writer.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+ReportWriter::ReportWriter(const std::string& pPath, const bool append) : path(pPath), mode(append ? std::ios::app : std::ios::trunc) {}
+
+ReportWriter::~ReportWriter() {
+    close();
+}
+
+bool ReportWriter::open() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open() && !closed) {
+        file.open(path, mode);
+    }
+    return file.is_open();
+}
+
+void ReportWriter::write(std::string text) {
+    if (text.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing || closed) {
+            return;
+        }
+        if (!file.is_open()) {
+            file.open(path, mode);
+            if (!file.is_open()) {
+                return;
+            }
+        }
+        pending.push_back(std::move(text));
+        if (!writeThread.joinable()) {
+            writeThread = std::thread(&ReportWriter::writeLoop, this);
+        }
+    }
+    batchReady.notify_one();
+}
+
+void ReportWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+            return;
+        }
+        closing = true;
+    }
+    batchReady.notify_one();
+    if (writeThread.joinable()) {
+        writeThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file.close();
+    closed = true;
+}
+
+/**
+ * The queue is swapped out while holding the lock, so the batches are written without it and callers never wait on the
+ * disk. The swapped out vector keeps its capacity for the next round.
+ */
+void ReportWriter::writeLoop() {
+    std::vector<std::string> batches;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchReady.wait(lock, [this] { return closing || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            batches.swap(pending);
+        }
+
+        for (const auto& batch : batches) {
+            file.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        }
+        if (!file) {
+            LOG_ERROR("Could not write to a report\n");
+        }
+        batches.clear();
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file run_merge.cpp
+ * @brief Source file for the run merge sort.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include "wells_fargo_statement_converter/run_merge.h"
+#include "wells_fargo_statement_converter/radix_sort.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+/**
+ * @brief The next transaction of a run, ordered so that earlier dates, then earlier runs, come out of the heap first.
+ */
+struct RunHead {
+    uint32_t key;
+    size_t run;
+
+    bool operator>(const RunHead& other) const {
+        return key != other.key ? key > other.key : run > other.run;
+    }
+};
+
+bool keyLess(const Transaction& first, const Transaction& second) {
+    return first.getDate().getKey() < second.getDate().getKey();
+}
+
+} // namespace
+
+/**
+ * Each run is checked on its own first, and the few that aren't already in date order are radix sorted in place.
+ * If the runs then follow one another in date order, nothing else needs to be done. Otherwise they are k-way merged
+ * with a min-heap of the first remaining transaction of each run. Ties are broken by run, so the result is the same
+ * as a stable sort of the whole vector.
+ */
+void RunMerge::sort(std::vector<Transaction>& vec, const std::vector<size_t>& runStarts) {
+    LOG_DEBUG("Merging ", runStarts.size(), " runs of ", vec.size(), " transactions\n");
+    if (vec.size() < 2) {
+        return;
+    }
+    if (runStarts.empty()) {
+        // ie. a store that was filled without starting a run. All of it is one run
+        sort(vec, std::vector<size_t>{0});
+        return;
+    }
+
+    std::vector<size_t> runEnds(runStarts.begin() + 1, runStarts.end());
+    runEnds.push_back(vec.size());
+
+    // Fix up runs that aren't sorted, and check if the runs are already in order
+    bool runsInOrder = true;
+    for (size_t run = 0; run < runStarts.size(); ++run) {
+        const auto runBegin = vec.begin() + runStarts[run];
+        const auto runEnd = vec.begin() + runEnds[run];
+        if (!std::is_sorted(runBegin, runEnd, keyLess)) {
+            LOG_DEBUG("Run ", run, " isn't in date order. Sorting it\n");
+            RadixSort::sort(runBegin, runEnd);
+        }
+        if (run > 0 && keyLess(*runBegin, *(runBegin - 1))) {
+            runsInOrder = false;
+        }
+    }
+    if (runsInOrder) {
+        LOG_DEBUG("Runs are already in order\n");
+        return;
+    }
+
+    std::priority_queue<RunHead, std::vector<RunHead>, std::greater<RunHead>> heads;
+    std::vector<size_t> positions(runStarts);
+    for (size_t run = 0; run < runStarts.size(); ++run) {
+        if (positions[run] < runEnds[run]) {
+            heads.push(RunHead{vec[positions[run]].getDate().getKey(), run});
+        }
+    }
+
+    std::vector<Transaction> merged;
+    merged.reserve(vec.size());
+    while (!heads.empty()) {
+        const size_t run = heads.top().run;
+        heads.pop();
+        merged.push_back(vec[positions[run]++]);
+        if (positions[run] < runEnds[run]) {
+            heads.push(RunHead{vec[positions[run]].getDate().getKey(), run});
+        }
+    }
+    vec.swap(merged);
+}
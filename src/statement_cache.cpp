@@ -0,0 +1,232 @@
+/**
+ * @file statement_cache.cpp
+ * @brief Source file for the StatementCache class.
+ */
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "wells_fargo_statement_converter/statement_cache.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+constexpr char MAGIC[4] = {'W', 'F', 'S', 'C'};
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+/**
+ * @brief Numbers the temporary files of save(), so that threads saving the same key don't write the same file.
+ */
+std::atomic<uint64_t> tempFileCount{0};
+
+uint64_t fnv1a(const char* data, const size_t size, uint64_t hash = FNV_OFFSET) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t fnv1a(const std::string& str, const uint64_t hash = FNV_OFFSET) {
+    // Include the length so that "ab" + "c" and "a" + "bc" hash differently
+    const uint64_t size = str.size();
+    return fnv1a(str.data(), str.size(), fnv1a(reinterpret_cast<const char*>(&size), sizeof(size), hash));
+}
+
+/**
+ * @brief Appends raw values and strings to a byte buffer.
+ */
+class Writer {
+public:
+    template <typename T>
+    void put(const T value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const std::string_view str) {
+        put<uint32_t>(static_cast<uint32_t>(str.size()));
+        bytes.append(str.data(), str.size());
+    }
+
+    std::string bytes;
+};
+
+/**
+ * @brief Reads back what Writer wrote. Every read fails once the data runs out.
+ */
+class Reader {
+public:
+    explicit Reader(const std::string& pBytes) : bytes(pBytes) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (bytes.size() - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, bytes.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string_view& str) {
+        uint32_t size = 0;
+        if (!get(size) || bytes.size() - position < size) {
+            return false;
+        }
+        str = std::string_view(bytes.data() + position, size);
+        position += size;
+        return true;
+    }
+
+    bool atEnd() const {
+        return position == bytes.size();
+    }
+private:
+    const std::string& bytes;
+    size_t position = 0;
+};
+
+} // namespace
+
+StatementCache::StatementCache(const std::string& pDirectory) : directory(pDirectory) {
+    std::filesystem::create_directories(directory);
+}
+
+/**
+ * The statement is hashed with 64-bit FNV-1a, along with its file name, the version tag and the settings. Only the file
+ * name is hashed, not the directory, so moving the statements or naming their directory differently still hits the cache.
+ * The default settings are left out of the hash, so the keys of entries made before settings existed stay the same.
+ */
+uint64_t StatementCache::getKey(const std::string& file, const std::vector<char>& data, const std::string& settings) const {
+    uint64_t hash = fnv1a(std::filesystem::path(file).filename().string(), getVersionTag());
+    if (!settings.empty()) {
+        hash = fnv1a(settings, hash);
+    }
+    return fnv1a(data.data(), data.size(), hash);
+}
+
+/**
+ * Cache files that are cut short, or were written by a different version, are treated as missing.
+ */
+bool StatementCache::load(const uint64_t key, StatementResult& result) const {
+    const std::string path = getPath(key);
+    std::ifstream cacheFile(path, std::ios::binary);
+    if (!cacheFile) {
+        return false;
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(cacheFile)), std::istreambuf_iterator<char>());
+
+    Reader reader(bytes);
+    char magic[sizeof(MAGIC)];
+    uint64_t versionTag = 0;
+    uint64_t transactionCount = 0;
+    for (char& c : magic) {
+        if (!reader.get(c)) {
+            return false;
+        }
+    }
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.get(versionTag) || versionTag != getVersionTag() || !reader.get(transactionCount)) {
+        LOG_INFO("Ignoring cache file ", path, " since it isn't a valid cache file for this version\n");
+        return false;
+    }
+
+    TransactionStore transactions;
+    for (uint64_t i = 0; i < transactionCount; ++i) {
+        int64_t amount = 0;
+        int32_t year = 0;
+        int32_t month = 0;
+        int32_t day = 0;
+        std::string_view lastFour;
+        std::string_view refNum;
+        std::string_view name;
+        if (!reader.get(amount) || !reader.get(year) || !reader.get(month) || !reader.get(day)
+            || !reader.getString(lastFour) || !reader.getString(refNum) || !reader.getString(name)) {
+            LOG_INFO("Ignoring cache file ", path, " since it is cut short\n");
+            return false;
+        }
+
+        Transaction& transaction = transactions.add();
+        transaction.setAmount(amount);
+        transaction.setDate(Date(year, month, day));
+        transaction.setLastFour(lastFour);
+        transaction.setRefNum(refNum);
+        transaction.setName(transactions.storeName(name));
+    }
+
+    std::string_view skippedLines;
+    if (!reader.getString(skippedLines) || !reader.atEnd()) {
+        LOG_INFO("Ignoring cache file ", path, " since it is cut short\n");
+        return false;
+    }
+
+    result.transactions = std::move(transactions);
+    result.skippedLines.assign(skippedLines.data(), skippedLines.size());
+    return true;
+}
+
+/**
+ * The file is written under a temporary name first and then renamed, so a run that is interrupted never leaves a
+ * half-written cache file behind. Identical statements from different input directories have the same key, so every
+ * save gets its own temporary name, and whichever rename happens last wins with the same bytes.
+ */
+void StatementCache::save(const uint64_t key, const StatementResult& result) const {
+    Writer writer;
+    for (const char c : MAGIC) {
+        writer.put(c);
+    }
+    writer.put<uint64_t>(getVersionTag());
+    writer.put<uint64_t>(result.transactions.size());
+    for (const auto& transaction : result.transactions) {
+        writer.put<int64_t>(transaction.getAmount());
+        writer.put<int32_t>(transaction.getDate().getYear());
+        writer.put<int32_t>(transaction.getDate().getMonth());
+        writer.put<int32_t>(transaction.getDate().getDay());
+        writer.putString(transaction.getLastFour());
+        writer.putString(transaction.getRefNum());
+        writer.putString(transaction.getName());
+    }
+    writer.putString(result.skippedLines);
+
+    const std::string path = getPath(key);
+    const std::string tempPath = path + "." + std::to_string(tempFileCount++) + ".tmp";
+    {
+        std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+        cacheFile.write(writer.bytes.data(), static_cast<std::streamsize>(writer.bytes.size()));
+        if (!cacheFile) {
+            LOG_ERROR("Could not write cache file ", tempPath, "\n");
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR("Could not rename cache file ", tempPath, " to ", path, ": ", error.message(), "\n");
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+uint64_t StatementCache::getVersionTag() {
+    uint64_t tag = FNV_OFFSET;
+    const uint64_t numbers[] = {constants::PARSER_VERSION, constants::REF_NUM_SIZE, constants::LAST_FOUR_SIZE};
+    tag = fnv1a(reinterpret_cast<const char*>(numbers), sizeof(numbers), tag);
+    for (const std::string* pattern : {&constants::regex::TRANSACTION, &constants::regex::TRANSACTION_OLD, &constants::regex::TRANSACTION_INTEREST,
+                                       &constants::regex::TRANSACTION_SECTION_TITLE, &constants::regex::SKIP_LIST, &constants::regex::SKIPPED_RELEVANT,
+                                       &constants::regex::LAST_FOUR}) {
+        tag = fnv1a(*pattern, tag);
+    }
+    return tag;
+}
+
+std::string StatementCache::getPath(const uint64_t key) const {
+    static const char HEX[] = "0123456789abcdef";
+    std::string name(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        name[i] = HEX[(key >> ((15 - i) * 4)) & 0xF];
+    }
+    return directory + "/" + name + ".bin";
+}
@@ -0,0 +1,107 @@
+/**
+ * @file statistics.cpp
+ * @brief Source file for the timings and counters that are collected with --stats.
+ */
+#include <fstream>
+#include <iomanip>
+#include "wells_fargo_statement_converter/statistics.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/json.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+double toMilliseconds(const std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/**
+ * @brief Writes the fields that the per-statement entries and the totals have in common.
+ */
+void writeCounters(std::ofstream& file, const StatementStatistics& statistics, const std::string& indent) {
+    file << indent << "\"pages\": " << statistics.pages << ",\n"
+         << indent << "\"prunedPages\": " << statistics.prunedPages << ",\n"
+         << indent << "\"lines\": " << statistics.lines << ",\n"
+         << indent << "\"matched\": " << statistics.matched << ",\n"
+         << indent << "\"skipped\": " << statistics.skipped << ",\n"
+         << indent << "\"possiblyRelevant\": " << statistics.possiblyRelevant << ",\n"
+         << indent << "\"duplicates\": " << statistics.duplicates << ",\n"
+         << indent << "\"textBytes\": " << statistics.textBytes << ",\n"
+         << indent << "\"readMs\": " << toMilliseconds(statistics.readTime) << ",\n"
+         << indent << "\"loadMs\": " << toMilliseconds(statistics.loadTime) << ",\n"
+         << indent << "\"extractMs\": " << toMilliseconds(statistics.extractTime) << ",\n"
+         << indent << "\"classifyMs\": " << toMilliseconds(statistics.classifyTime) << ",\n"
+         << indent << "\"generateMs\": " << toMilliseconds(statistics.generateTime);
+}
+
+} // namespace
+
+void StatementStatistics::add(const StatementStatistics& other) {
+    pages += other.pages;
+    prunedPages += other.prunedPages;
+    lines += other.lines;
+    matched += other.matched;
+    skipped += other.skipped;
+    possiblyRelevant += other.possiblyRelevant;
+    duplicates += other.duplicates;
+    textBytes += other.textBytes;
+    readTime += other.readTime;
+    loadTime += other.loadTime;
+    extractTime += other.extractTime;
+    classifyTime += other.classifyTime;
+    generateTime += other.generateTime;
+}
+
+/**
+ * The report has the run-wide stage timings, the totals of the per-statement counters, and an entry for each statement.
+ * All timings are in milliseconds.
+ */
+void Statistics::writeJson(const std::string& path) const {
+    LOG_INFO("Writing statistics to ", path, "\n");
+
+    std::ofstream file(path);
+    if (!file) {
+        LOG_ERROR("Couldn't open ", path, "\n");
+        throw Exception("Couldn't open " + path);
+    }
+    file << std::fixed << std::setprecision(3);
+
+    StatementStatistics totals;
+    size_t cachedCount = 0;
+    for (const auto& statement : statements) {
+        totals.add(statement);
+        cachedCount += statement.cached;
+    }
+
+    file << "{\n"
+         << "  \"threads\": " << threadCount << ",\n"
+         << "  \"pageThreads\": " << pageThreadCount << ",\n"
+         << "  \"stages\": {\n"
+         << "    \"gatherPdfFilesMs\": " << toMilliseconds(gatherTime) << ",\n"
+         << "    \"processPdfsMs\": " << toMilliseconds(processTime) << ",\n"
+         << "    \"sortTransactionsMs\": " << toMilliseconds(sortTime) << ",\n"
+         << "    \"generateCsvFileMs\": " << toMilliseconds(csvTime) << "\n"
+         << "  },\n"
+         << "  \"totals\": {\n"
+         << "    \"files\": " << statements.size() << ",\n"
+         << "    \"cached\": " << cachedCount << ",\n"
+         << "    \"spills\": " << spillCount << ",\n";
+    writeCounters(file, totals, "    ");
+    file << "\n  },\n"
+         << "  \"files\": [";
+
+    for (size_t i = 0; i < statements.size(); ++i) {
+        file << (i == 0 ? "\n" : ",\n") << "    {\n      \"file\": ";
+        json::writeString(file, statements[i].file);
+        file << ",\n      \"cached\": " << (statements[i].cached ? "true" : "false") << ",\n";
+        writeCounters(file, statements[i], "      ");
+        file << "\n    }";
+    }
+    file << (statements.empty() ? "]\n" : "\n  ]\n") << "}\n";
+
+    file.close();
+    if (!file) {
+        LOG_ERROR("Couldn't write ", path, "\n");
+        throw Exception("Couldn't write " + path);
+    }
+}
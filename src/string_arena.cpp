@@ -0,0 +1,81 @@
+/**
+ * @file string_arena.cpp
+ * @brief Source file for the StringArena class.
+ */
+#include <cstring>
+#include <iterator>
+#include "wells_fargo_statement_converter/string_arena.h"
+
+/**
+ * Strings are appended to the last block until it is full. A string that doesn't fit gets a new block. Strings that are
+ * longer than a regular block get a block of exactly their size, which is slotted in before the last block so the free
+ * space in the last block can still be used.
+ */
+std::string_view StringArena::store(const std::string_view str) {
+    if (str.empty()) {
+        return std::string_view();
+    }
+
+    if (str.size() > BLOCK_SIZE) {
+        std::unique_ptr<char[]> block(new char[str.size()]);
+        std::memcpy(block.get(), str.data(), str.size());
+        const char* data = block.get();
+        blocks.insert(blocks.empty() ? blocks.end() : std::prev(blocks.end()), std::move(block));
+        allocatedBytes += str.size();
+        return std::string_view(data, str.size());
+    }
+
+    if (blocks.empty() || blockCapacity - blockUsed < str.size()) {
+        blocks.emplace_back(new char[BLOCK_SIZE]);
+        blockUsed = 0;
+        blockCapacity = BLOCK_SIZE;
+        allocatedBytes += BLOCK_SIZE;
+    }
+
+    char* data = blocks.back().get() + blockUsed;
+    std::memcpy(data, str.data(), str.size());
+    blockUsed += str.size();
+    return std::string_view(data, str.size());
+}
+
+/**
+ * The other arena's blocks are put in front of this arena's blocks, so this arena can keep filling its own last block.
+ */
+void StringArena::append(StringArena&& other) {
+    if (other.blocks.empty()) {
+        return;
+    }
+    if (blocks.empty()) {
+        *this = std::move(other);
+        other.clear();
+        return;
+    }
+
+    blocks.insert(blocks.begin(), std::make_move_iterator(other.blocks.begin()), std::make_move_iterator(other.blocks.end()));
+    allocatedBytes += other.allocatedBytes;
+    other.clear();
+}
+
+void StringArena::clear() {
+    blocks.clear();
+    blockUsed = 0;
+    blockCapacity = 0;
+    allocatedBytes = 0;
+}
+
+void StringArena::reset() {
+    if (blockCapacity != BLOCK_SIZE) {
+        clear();
+        return;
+    }
+
+    std::unique_ptr<char[]> last = std::move(blocks.back());
+    blocks.clear();
+    blocks.push_back(std::move(last));
+    blockUsed = 0;
+    allocatedBytes = BLOCK_SIZE;
+}
+
+size_t StringArena::getMemoryFootprint() const {
+    return allocatedBytes + blocks.capacity() * sizeof(std::unique_ptr<char[]>);
+}
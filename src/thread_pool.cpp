@@ -0,0 +1,141 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Source file for the ThreadPool class.
+ */
+#include <algorithm>
+#include "wells_fargo_statement_converter/thread_pool.h"
+
+ThreadPool::ThreadPool(const unsigned int threadCount) {
+    const unsigned int workerCount = (threadCount > 1) ? threadCount - 1 : 0;
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * With no workers, or a single index, the indices are simply run in order on the calling thread.
+ * Otherwise the job is queued so idle workers can pick up indices, and the caller starts working on it too.
+ * The caller then waits until the last running index has finished.
+ */
+void ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    if (workers.empty() || count == 1) {
+        std::exception_ptr error;
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                task(i);
+            }
+            catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->count = count;
+    job->task = &task;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    jobAvailable.notify_all();
+
+    runJob(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done.wait(lock, [&job] { return job->finished.load() == job->count; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.erase(std::remove(jobs.begin(), jobs.end(), job), jobs.end());
+    }
+
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+unsigned int ThreadPool::getThreadCount() const {
+    return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+unsigned int ThreadPool::defaultThreadCount() {
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return (hardwareThreads == 0) ? 1 : hardwareThreads;
+}
+
+/**
+ * Indices are handed out with an atomic counter, so threads that finish early just take the next one.
+ * Only the lowest-index exception is kept so the rethrown error doesn't depend on thread timing.
+ */
+void ThreadPool::runJob(Job& job) {
+    while (true) {
+        const size_t index = job.next.fetch_add(1);
+        if (index >= job.count) {
+            return;
+        }
+
+        try {
+            (*job.task)(index);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            if (!job.error || index < job.errorIndex) {
+                job.error = std::current_exception();
+                job.errorIndex = index;
+            }
+        }
+
+        if (job.finished.fetch_add(1) + 1 == job.count) {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.done.notify_all();
+        }
+    }
+}
+
+/**
+ * Workers always help the oldest queued job first. Once a job has handed out all of its indices it is dropped from the
+ * queue, which lets workers move on to jobs queued later, including ones queued from inside a running task.
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty()) {
+                return;
+            }
+
+            job = jobs.front();
+            if (job->next.load() >= job->count) {
+                jobs.pop_front();
+                continue;
+            }
+        }
+
+        runJob(*job);
+    }
+}
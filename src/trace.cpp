@@ -0,0 +1,93 @@
+/**
+ * @file trace.cpp
+ * @brief Source file for the trace spans that are collected with --trace.
+ */
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include "wells_fargo_statement_converter/trace.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/json.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+double toMicroseconds(const std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+Tracer::Tracer() : startTime(std::chrono::steady_clock::now()) {}
+
+void Tracer::record(Event&& event) {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back(std::move(event));
+}
+
+/**
+ * Every span is a complete ("X") event, with its file, page and counters as its arguments. Each thread also gets a
+ * thread_name metadata ("M") event, so the viewer labels its timeline. Times are in microseconds.
+ */
+void Tracer::writeJson(const std::string& path) const {
+    LOG_INFO("Writing trace to ", path, "\n");
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::ofstream file(path);
+    if (!file) {
+        LOG_ERROR("Couldn't open ", path, "\n");
+        throw Exception("Couldn't open " + path);
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [\n";
+    std::set<uint32_t> threads;
+    for (const auto& event : events) {
+        threads.insert(event.thread);
+    }
+    bool first = true;
+    for (const uint32_t thread : threads) {
+        file << (first ? "" : ",\n") << "    {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+             << ", \"args\": {\"name\": \"thread " << thread << "\"}}";
+        first = false;
+    }
+    for (const auto& event : events) {
+        file << (first ? "" : ",\n") << "    {\"name\": ";
+        json::writeString(file, event.name);
+        file << ", \"cat\": \"converter\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+             << ", \"ts\": " << toMicroseconds(event.startTime - startTime) << ", \"dur\": " << toMicroseconds(event.duration)
+             << ", \"args\": {";
+        const char* separator = "";
+        if (!event.file.empty()) {
+            file << "\"file\": ";
+            json::writeString(file, event.file);
+            separator = ", ";
+        }
+        if (event.page >= 0) {
+            file << separator << "\"page\": " << event.page;
+            separator = ", ";
+        }
+        for (const auto& counter : event.counters) {
+            file << separator;
+            json::writeString(file, counter.first);
+            file << ": " << counter.second;
+            separator = ", ";
+        }
+        file << "}}";
+        first = false;
+    }
+    file << "\n  ]\n}\n";
+
+    file.close();
+    if (!file) {
+        LOG_ERROR("Couldn't write ", path, "\n");
+        throw Exception("Couldn't write " + path);
+    }
+}
+
+uint32_t Tracer::getThreadNumber() {
+    static std::atomic<uint32_t> nextNumber(0);
+    thread_local const uint32_t number = nextNumber++;
+    return number;
+}
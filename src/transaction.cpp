@@ -2,51 +2,118 @@
  * @file transaction.cpp
  * @brief Source file for the Transaction class.
  */
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <charconv>
+#include <limits>
 #include "wells_fargo_statement_converter/transaction.h"
 
-Transaction::Transaction() {}
+Transaction::Transaction() : date(0, 0, 0) {}
 
-Transaction::Transaction(const double pAmount, const std::string pName, const Date& pDate, const std::string pReferenceNum, const std::string pLastFour)
-    : amount(pAmount), name(pName), date(pDate), referenceNum(pReferenceNum), lastFour(pLastFour) {}
+Transaction::Transaction(const int64_t pAmount, const std::string_view pName, const Date& pDate, const std::string_view pReferenceNum, const std::string_view pLastFour)
+    : amount(pAmount), name(pName), date(pDate) {
+    setRefNum(pReferenceNum);
+    setLastFour(pLastFour);
+}
+
+std::string Transaction::getCsvFormat() const {
+    std::string csv;
+    appendCsvFormat(csv);
+    return csv;
+}
+
+/**
+ * Numbers are written with std::to_chars into a small buffer on the stack. The month and day are padded to 2 digits and
+ * the year to 4 digits with zeros.
+ */
+void Transaction::appendCsvFormat(std::string& csv) const {
+    char digits[24]; // Enough for any int64_t
+    const auto appendPadded = [&csv, &digits](const int value, const size_t width) {
+        const std::to_chars_result written = std::to_chars(digits, digits + sizeof(digits), value);
+        const size_t length = static_cast<size_t>(written.ptr - digits);
+        if (length < width) {
+            csv.append(width - length, '0');
+        }
+        csv.append(digits, length);
+    };
 
-std::string Transaction::getCsvFormat() {
-    std::ostringstream oss;
     // Last four
-    oss << "\"" << lastFour << "\",";
+    csv += '"';
+    csv.append(lastFour, lastFourLength);
+    csv += "\",";
 
     // Transaction date
-    oss << "\"";
-    oss << std::setw(2) << std::setfill('0') << date.getMonth();
-    oss << "/";
-    oss << std::setw(2) << std::setfill('0') << date.getDay();
-    oss << "/";
-    oss << std::setw(4) << date.getYear();
-    oss << "\",";
+    csv += '"';
+    appendPadded(date.getMonth(), 2);
+    csv += '/';
+    appendPadded(date.getDay(), 2);
+    csv += '/';
+    appendPadded(date.getYear(), 4);
+    csv += "\",";
 
     // Reference number
-    oss << "\"" << referenceNum << "\",";
+    csv += '"';
+    csv.append(referenceNum, referenceNumLength);
+    csv += "\",";
 
     // Name
-    oss << "\"" << name << "\",";
+    csv += '"';
+    csv.append(name.data(), name.size());
+    csv += "\",";
 
     // Amount
-    oss << "\"";
-    oss << std::fixed << std::setprecision(2) << -amount;
-    oss << "\"";
+    csv += '"';
+    appendAmount(csv, amount);
+    csv += '"';
+}
 
-    return oss.str();
+/**
+ * Statements only have positive amounts, but refunds could be stored as negative ones. A '-' is written in front of
+ * the rest, even when the amount is 0.
+ */
+void Transaction::appendAmount(std::string& csv, const int64_t amount) {
+    char digits[24]; // Enough for any int64_t
+    uint64_t magnitude = static_cast<uint64_t>(amount);
+    if (amount >= 0) {
+        csv += '-';
+    }
+    else {
+        magnitude = 0 - magnitude;
+    }
+    const std::to_chars_result written = std::to_chars(digits, digits + sizeof(digits), magnitude / 100);
+    csv.append(digits, static_cast<size_t>(written.ptr - digits));
+    csv += '.';
+    csv += static_cast<char>('0' + magnitude % 100 / 10);
+    csv += static_cast<char>('0' + magnitude % 10);
 }
 
 Date& Transaction::getDate() {
     return date;
 }
 
-void Transaction::setAmount(const double pAmount) {
+const Date& Transaction::getDate() const {
+    return date;
+}
+
+int64_t Transaction::getAmount() const {
+    return amount;
+}
+
+std::string_view Transaction::getName() const {
+    return name;
+}
+
+std::string_view Transaction::getRefNum() const {
+    return std::string_view(referenceNum, referenceNumLength);
+}
+
+std::string_view Transaction::getLastFour() const {
+    return std::string_view(lastFour, lastFourLength);
+}
+
+void Transaction::setAmount(const int64_t pAmount) {
     amount = pAmount;
 }
-void Transaction::setName(const std::string pName) {
+void Transaction::setName(const std::string_view pName) {
     name = pName;
 }
 
@@ -54,10 +121,42 @@ void Transaction::setDate(const Date& pDate) {
     date = pDate;
 }
 
-void Transaction::setRefNum(const std::string pRefNum) {
-    referenceNum = pRefNum;
+void Transaction::setRefNum(const std::string_view pRefNum) {
+    referenceNumLength = static_cast<uint8_t>(std::min(pRefNum.size(), constants::REF_NUM_SIZE));
+    std::copy_n(pRefNum.data(), referenceNumLength, referenceNum);
 }
 
-void Transaction::setLastFour(const std::string pLastFour) {
-    lastFour = pLastFour;
+void Transaction::setLastFour(const std::string_view pLastFour) {
+    lastFourLength = static_cast<uint8_t>(std::min(pLastFour.size(), constants::LAST_FOUR_SIZE));
+    std::copy_n(pLastFour.data(), lastFourLength, lastFour);
+}
+
+/**
+ * The digits are added up one by one, so nothing is rounded. Amounts too large for an int64_t are rejected.
+ */
+bool Transaction::parseAmount(const std::string_view text, int64_t& cents) {
+    if (text.size() < 4 || text[text.size() - 3] != '.') {
+        return false;
+    }
+
+    constexpr int64_t LIMIT = std::numeric_limits<int64_t>::max() / 10;
+    int64_t value = 0;
+    bool hasDigit = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (c == ',' && i < text.size() - 3) {
+            continue;
+        }
+        if (i == text.size() - 3) {
+            continue; // The '.'
+        }
+        if (c < '0' || c > '9' || value > LIMIT || (value == LIMIT && c - '0' > std::numeric_limits<int64_t>::max() % 10)) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+        hasDigit = true;
+    }
+
+    cents = value;
+    return hasDigit;
 }
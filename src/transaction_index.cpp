@@ -0,0 +1,144 @@
+/**
+ * @file transaction_index.cpp
+ * @brief Source file for the TransactionIndex class.
+ */
+#include <algorithm>
+#include <string_view>
+#include "wells_fargo_statement_converter/transaction_index.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+namespace {
+
+constexpr size_t MIN_SLOTS = 1024;
+
+void hashBytes(uint64_t& hash, const std::string_view bytes) {
+    for (const char c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull; // FNV-1a
+    }
+}
+
+void hashNumber(uint64_t& hash, const uint64_t number) {
+    hash ^= number;
+    hash *= 1099511628211ull;
+}
+
+} // namespace
+
+/**
+ * Linear probing. The table is kept at most 70% full, so the runs of used slots stay short.
+ */
+bool TransactionIndex::insert(const std::vector<Transaction>& transactions, const Transaction& transaction, const size_t position) {
+    if ((count + 1) * 10 > slots.size() * 7) {
+        grow(transactions);
+    }
+
+    const uint64_t transactionHash = hash(transaction);
+    const uint32_t tag = static_cast<uint32_t>(transactionHash >> 32);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = transactionHash & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.position == EMPTY) {
+            slot.position = static_cast<uint32_t>(position);
+            slot.tag = tag;
+            count++;
+            return true;
+        }
+        if (slot.tag == tag && isSame(transactions[slot.position], transaction)) {
+            return false;
+        }
+    }
+}
+
+size_t TransactionIndex::find(const std::vector<Transaction>& transactions, const Transaction& transaction) const {
+    if (slots.empty()) {
+        return NOT_FOUND;
+    }
+
+    const uint64_t transactionHash = hash(transaction);
+    const uint32_t tag = static_cast<uint32_t>(transactionHash >> 32);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = transactionHash & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.position == EMPTY) {
+            return NOT_FOUND;
+        }
+        if (slot.tag == tag && isSame(transactions[slot.position], transaction)) {
+            return slot.position;
+        }
+    }
+}
+
+void TransactionIndex::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    count = 0;
+}
+
+/**
+ * Emptying the table touches every slot, so a table that grew far past its first size is freed instead, rather than
+ * making every later reset as slow as the largest set of transactions.
+ */
+void TransactionIndex::reset() {
+    if (slots.size() > MIN_SLOTS * 16) {
+        clear();
+        return;
+    }
+    std::fill(slots.begin(), slots.end(), Slot());
+    count = 0;
+}
+
+size_t TransactionIndex::size() const {
+    return count;
+}
+
+/**
+ * FNV-1a over the fields, finished with the mixing step of splitmix64 so the lower bits, which pick the slot, depend
+ * on every field.
+ */
+uint64_t TransactionIndex::hash(const Transaction& transaction) {
+    uint64_t hash = 14695981039346656037ull;
+    hashBytes(hash, transaction.getLastFour());
+    hashBytes(hash, transaction.getRefNum());
+    hashNumber(hash, transaction.getDate().getKey());
+    hashNumber(hash, static_cast<uint64_t>(transaction.getAmount()));
+    if (transaction.getRefNum().empty()) {
+        hashBytes(hash, transaction.getName());
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+bool TransactionIndex::isSame(const Transaction& first, const Transaction& second) {
+    return first.getAmount() == second.getAmount()
+        && first.getDate().getKey() == second.getDate().getKey()
+        && first.getRefNum() == second.getRefNum()
+        && first.getLastFour() == second.getLastFour()
+        && (!first.getRefNum().empty() || first.getName() == second.getName());
+}
+
+/**
+ * The hashes aren't kept, so they are taken again from the transactions.
+ */
+void TransactionIndex::grow(const std::vector<Transaction>& transactions) {
+    std::vector<Slot> oldSlots(std::max(MIN_SLOTS, slots.size() * 2));
+    oldSlots.swap(slots);
+    LOG_DEBUG("Growing the transaction index to ", slots.size(), " slots\n");
+
+    const size_t mask = slots.size() - 1;
+    for (const Slot& oldSlot : oldSlots) {
+        if (oldSlot.position == EMPTY) {
+            continue;
+        }
+        size_t i = hash(transactions[oldSlot.position]) & mask;
+        while (slots[i].position != EMPTY) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = oldSlot;
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file transaction_store.cpp
+ * @brief Source file for the TransactionStore class.
+ */
+#include "wells_fargo_statement_converter/transaction_store.h"
+
+Transaction& TransactionStore::add() {
+    if (runStarts.empty()) {
+        runStarts.push_back(0);
+    }
+    transactions.emplace_back();
+    return transactions.back();
+}
+
+std::string_view TransactionStore::storeName(const std::string_view name) {
+    return names.store(name);
+}
+
+/**
+ * The transactions are copied over by value. Their names keep pointing to the same memory, because the blocks of the
+ * other store's arena are handed over as well. The runs of the other store are kept, shifted to their new positions.
+ */
+void TransactionStore::append(TransactionStore&& other) {
+    if (other.empty()) {
+        other.clear();
+        return;
+    }
+
+    const size_t offset = transactions.size();
+    for (const size_t runStart : other.runStarts) {
+        runStarts.push_back(offset + runStart);
+    }
+
+    if (transactions.empty()) {
+        transactions = std::move(other.transactions);
+    }
+    else {
+        transactions.insert(transactions.end(), other.transactions.begin(), other.transactions.end());
+    }
+    names.append(std::move(other.names));
+    other.clear();
+}
+
+const std::vector<size_t>& TransactionStore::getRunStarts() const {
+    return runStarts;
+}
+
+void TransactionStore::clear() {
+    transactions.clear();
+    transactions.shrink_to_fit();
+    names.clear();
+    runStarts.clear();
+}
+
+void TransactionStore::reset() {
+    transactions.clear();
+    names.reset();
+    runStarts.clear();
+}
+
+size_t TransactionStore::size() const {
+    return transactions.size();
+}
+
+bool TransactionStore::empty() const {
+    return transactions.empty();
+}
+
+size_t TransactionStore::getMemoryFootprint() const {
+    return transactions.capacity() * sizeof(Transaction) + names.getMemoryFootprint();
+}
+
+std::vector<Transaction>& TransactionStore::getTransactions() {
+    return transactions;
+}
+
+Transaction& TransactionStore::operator[](const size_t idx) {
+    return transactions[idx];
+}
+
+const Transaction& TransactionStore::operator[](const size_t idx) const {
+    return transactions[idx];
+}
+
+TransactionStore::iterator TransactionStore::begin() {
+    return transactions.begin();
+}
+
+TransactionStore::iterator TransactionStore::end() {
+    return transactions.end();
+}
+
+TransactionStore::const_iterator TransactionStore::begin() const {
+    return transactions.begin();
+}
+
+TransactionStore::const_iterator TransactionStore::end() const {
+    return transactions.end();
+}
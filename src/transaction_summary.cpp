@@ -0,0 +1,111 @@
+/**
+ * @file transaction_summary.cpp
+ * @brief Source file for the TransactionSummary class.
+ */
+#include <algorithm>
+#include <string_view>
+#include "wells_fargo_statement_converter/transaction_summary.h"
+#include "wells_fargo_statement_converter/csv_writer.h"
+
+namespace {
+
+/**
+ * @brief Sorts the numbers of interned strings by their strings.
+ */
+std::vector<uint32_t> sortedIds(const NameInterner& names) {
+    std::vector<uint32_t> ids(names.size());
+    for (uint32_t id = 0; id < ids.size(); ++id) {
+        ids[id] = id;
+    }
+    std::sort(ids.begin(), ids.end(), [&names](const uint32_t first, const uint32_t second) {
+        return names.getName(first) < names.getName(second);
+    });
+    return ids;
+}
+
+void appendRow(std::string& row, const std::string_view group, const std::string_view key, const size_t count, const int64_t amount) {
+    row += '"';
+    row.append(group.data(), group.size());
+    row += "\",\"";
+    row.append(key.data(), key.size());
+    row += "\",\"";
+    row += std::to_string(count);
+    row += "\",\"";
+    Transaction::appendAmount(row, amount);
+    row += "\"\n";
+}
+
+} // namespace
+
+void TransactionSummary::add(const Transaction& transaction) {
+    const auto addTo = [&transaction](Total& total) {
+        total.count++;
+        total.amount += transaction.getAmount();
+    };
+
+    const uint32_t account = accountNames.intern(transaction.getLastFour());
+    if (account == accounts.size()) {
+        accounts.emplace_back();
+    }
+    addTo(accounts[account]);
+
+    const uint32_t month = transaction.getDate().getKey() / 100;
+    if (months.empty() || months.back().first != month) {
+        auto position = std::lower_bound(months.begin(), months.end(), month, [](const std::pair<uint32_t, Total>& entry, const uint32_t key) {
+            return entry.first < key;
+        });
+        if (position == months.end() || position->first != month) {
+            position = months.insert(position, {month, Total()});
+        }
+        addTo(position->second);
+    }
+    else {
+        addTo(months.back().second);
+    }
+
+    const uint32_t merchant = merchantNames.intern(transaction.getName());
+    if (merchant == merchants.size()) {
+        merchants.emplace_back();
+    }
+    addTo(merchants[merchant]);
+}
+
+void TransactionSummary::write(const std::string& path) const {
+    CsvWriter file(path);
+    std::string row;
+
+    for (const uint32_t id : sortedIds(accountNames)) {
+        row.clear();
+        appendRow(row, "account", accountNames.getName(id), accounts[id].count, accounts[id].amount);
+        file.write(row);
+    }
+
+    for (const auto& month : months) {
+        std::string key = std::to_string(month.first % 100);
+        key.insert(0, 2 - std::min<size_t>(key.size(), 2), '0');
+        const std::string year = std::to_string(month.first / 100);
+        key += '/';
+        key.append(4 - std::min<size_t>(year.size(), 4), '0');
+        key += year;
+
+        row.clear();
+        appendRow(row, "month", key, month.second.count, month.second.amount);
+        file.write(row);
+    }
+
+    for (const uint32_t id : sortedIds(merchantNames)) {
+        row.clear();
+        appendRow(row, "merchant", merchantNames.getName(id), merchants[id].count, merchants[id].amount);
+        file.write(row);
+    }
+
+    file.close();
+}
+
+void TransactionSummary::clear() {
+    accountNames.clear();
+    accounts.clear();
+    months.clear();
+    merchantNames.clear();
+    merchants.clear();
+}
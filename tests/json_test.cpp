@@ -0,0 +1,26 @@
+/**
+ * @file json_test.cpp
+ * @brief Tests for the JSON helpers.
+ */
+#include <sstream>
+#include <string>
+#include "test.h"
+#include "wells_fargo_statement_converter/json.h"
+
+TEST(jsonStringsAreEscaped) {
+    std::ostringstream stream;
+    json::writeString(stream, std::string("a\"b\\c\nd\te") + '\0' + "\x1f" + "f\xc3\xa9");
+    CHECK(stream.str() == std::string("\"a\\\"b\\\\c\\u000ad\\u0009e\\u0000\\u001ff\xc3\xa9\""));
+
+    // The hex escapes don't leak into the numbers written after the string
+    stream.str("");
+    json::writeString(stream, "\n");
+    stream << ' ' << 255 << ' ';
+    stream.width(3);
+    stream << 7;
+    CHECK(stream.str() == "\"\\u000a\" 255   7");
+
+    stream.str("");
+    json::writeString(stream, "");
+    CHECK(stream.str() == "\"\"");
+}
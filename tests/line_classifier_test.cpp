@@ -0,0 +1,236 @@
+/**
+ * @file line_classifier_test.cpp
+ * @brief Tests for the LineClassifier class.
+ */
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "test.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/line_classifier.h"
+
+namespace {
+
+/**
+ * @brief Checks that the scanner classifies a line exactly like the regex patterns do, kind and fields, and that the
+ * prefilter only rejects lines the patterns find irrelevant.
+ */
+void checkAgrees(const std::string& line, const char* file, const int lineNumber) {
+    const LineMatch scanned = LineClassifier::scan(line);
+    const LineMatch matched = LineClassifier::matchRegex(line);
+    if (!(scanned == matched)) {
+        test::fail(("scan() == matchRegex() for \"" + line + "\"").c_str(), file, lineNumber);
+    }
+    if (!LineClassifier::prefilter(line) && matched.kind != LineKind::Irrelevant) {
+        test::fail(("prefilter() passes \"" + line + "\"").c_str(), file, lineNumber);
+    }
+    if (!(LineClassifier::classify(line, ClassifierMode::Scanner) == LineClassifier::classify(line, ClassifierMode::Regex))) {
+        test::fail(("classify() agrees in both modes for \"" + line + "\"").c_str(), file, lineNumber);
+    }
+}
+
+#define CHECK_AGREES(line) checkAgrees(line, __FILE__, __LINE__)
+
+/**
+ * @brief Makes random lines that are put together like the transaction layouts, or out of random pieces of statement
+ * lines, so most of them come close to matching a pattern.
+ *
+ * Every field is picked from values that fit it and values that almost do. A few characters of some lines are then
+ * changed at random, to land right next to what the patterns accept.
+ */
+class LineFuzzer {
+public:
+    explicit LineFuzzer(const uint32_t seed) : random(seed) {}
+
+    std::string next() {
+        // Made on first use, since the constants of other files might not be initialized before this file's statics
+        static const Field LAST_FOURS = {{"1234", "7", "00012", "12a4", "", "-1"}, 3};
+        static const Field DATES = {{"12/05", "01/31", "99/99", "1/05", "12/5", "12-05", "12/055"}, 3};
+        static const Field REFERENCE_NUMS = {{"Q75MGCV0RAECBMV6T", "DKG0R4VF", "A", "#", "12/05", "92.30", ""}, 6};
+        static const Field NAMES = {{
+            "MCDONALDS", "TRADER JOE S #123  SAN JOSE CA", "X", "12.34", "$", "12/05", "A\rB", constants::regex::INTEREST_CHARGE,
+            constants::regex::ONLINE_PAYMENT + " THANK YOU", constants::regex::LAST_STATEMENT_BALANCE + " 1234", "",
+        }, 10};
+        static const Field AMOUNTS = {{"92.30", "9,058.81", "1,234,567.00", ",5.00", "0.07", "1.2.34", "12", "12.3", "12.345", ".99", "$25.00"}, 6};
+        static const Field PIECES = {{"Total fees", "Page 2 of 4", "$", "-", "Minimum Payment", "$25.00", "12.34", "12/05", "1234"}, 9};
+
+        std::string line = pick(SPACES);
+        switch (pick(4)) {
+            case 0:
+                line += pick(LAST_FOURS) + pick(SPACES) + pick(DATES) + pick(SPACES) + pick(DATES) + pick(SPACES) + pick(REFERENCE_NUMS)
+                      + pick(SPACES) + pick(NAMES) + pick(SPACES) + pick(AMOUNTS);
+                break;
+            case 1:
+                line += pick(DATES) + pick(SPACES) + pick(DATES) + pick(SPACES) + constants::regex::INTEREST_CHARGE + pick(SPACES) + pick(AMOUNTS);
+                break;
+            case 2:
+                line += pick(DATES) + pick(SPACES) + pick(DATES) + pick(SPACES) + pick(REFERENCE_NUMS) + pick(SPACES) + pick(NAMES)
+                      + pick(SPACES) + pick(AMOUNTS);
+                break;
+            default:
+                for (size_t i = pick(6) + 1; i > 0; --i) {
+                    line += pick(PIECES) + pick(SPACES);
+                }
+                break;
+        }
+        line += pick(TRAILERS);
+
+        if (pick(4) == 0) {
+            for (size_t i = pick(3) + 1; i > 0 && !line.empty(); --i) {
+                line[pick(line.size())] = CHARACTERS[pick(CHARACTERS.size())];
+            }
+        }
+        return line;
+    }
+private:
+    size_t pick(const size_t count) {
+        return std::uniform_int_distribution<size_t>(0, count - 1)(random);
+    }
+
+    /**
+     * @brief Values that can go in one place of a line. The first ones fit the patterns, and are picked more often.
+     */
+    struct Field {
+        std::vector<std::string> values;
+        size_t validCount;
+    };
+
+    const std::string& pick(const Field& field) {
+        return field.values[pick(3) != 0 ? pick(field.validCount) : pick(field.values.size())];
+    }
+
+    inline static const Field SPACES = {{" ", "  ", "\t", ""}, 3};
+    inline static const Field TRAILERS = {{"", " ", "\r", " \r", "\n", "x"}, 4};
+    inline static const std::string CHARACTERS = "0123456789/.,$ \t\rAZaz#*-";
+
+    std::mt19937 random;
+};
+
+} // namespace
+
+/**
+ * Runs both classifiers on many random lines. Any line they disagree on is printed.
+ */
+TEST(scannerAgreesWithRegexOnRandomLines) {
+    LineFuzzer fuzzer(1);
+    for (int i = 0; i < 20000; ++i) {
+        CHECK_AGREES(fuzzer.next());
+    }
+}
+
+namespace {
+
+/**
+ * @brief Checks that both classifiers agree on a line, and that it is the expected kind.
+ */
+void checkKind(const std::string& line, const LineKind kind, const char* file, const int lineNumber) {
+    checkAgrees(line, file, lineNumber);
+    if (LineClassifier::scan(line).kind != kind) {
+        test::fail(("scan() has the expected kind for \"" + line + "\"").c_str(), file, lineNumber);
+    }
+}
+
+#define CHECK_KIND(line, kind) checkKind(line, kind, __FILE__, __LINE__)
+
+/**
+ * @brief The text of a field of a line.
+ */
+std::string_view field(const std::string& line, const FieldSpan& span) {
+    return std::string_view(line).substr(span.offset, span.length);
+}
+
+} // namespace
+
+TEST(scannerFindsTheFieldsOfEveryLayout) {
+    const std::string current = "1234 12/05 12/06 Q75MGCV0RAECBMV6T TRADER JOE S #123  SAN JOSE CA 9,058.81";
+    const LineMatch match = LineClassifier::scan(current);
+    CHECK(match.kind == LineKind::Transaction);
+    CHECK(field(current, match.lastFour) == "1234");
+    CHECK(field(current, match.transactionDate) == "12/05");
+    CHECK(field(current, match.postDate) == "12/06");
+    CHECK(field(current, match.referenceNum) == "Q75MGCV0RAECBMV6T");
+    CHECK(field(current, match.name) == "TRADER JOE S #123  SAN JOSE CA");
+    CHECK(field(current, match.amount) == "9,058.81");
+    CHECK_AGREES(current);
+
+    const std::string interest = "   12/16  12/23  INTEREST CHARGE ON PURCHASES     6,871.13";
+    const LineMatch interestMatch = LineClassifier::scan(interest);
+    CHECK(interestMatch.kind == LineKind::TransactionInterest);
+    CHECK(field(interest, interestMatch.transactionDate) == "12/16");
+    CHECK(field(interest, interestMatch.postDate) == "12/23");
+    CHECK(field(interest, interestMatch.amount) == "6,871.13");
+    CHECK(interestMatch.referenceNum.length == 0);
+    CHECK_AGREES(interest);
+
+    const std::string old = "12/09 12/16 LFNKABD32R136G0S7 NETFLIX.COM 34.08";
+    const LineMatch oldMatch = LineClassifier::scan(old);
+    CHECK(oldMatch.kind == LineKind::TransactionOld);
+    CHECK(oldMatch.lastFour.length == 0);
+    CHECK(field(old, oldMatch.referenceNum) == "LFNKABD32R136G0S7");
+    CHECK(field(old, oldMatch.name) == "NETFLIX.COM");
+    CHECK(field(old, oldMatch.amount) == "34.08");
+    CHECK_AGREES(old);
+}
+
+TEST(scannerAgreesWithRegexOnEdgeCases) {
+    // The skip list, in both transaction layouts
+    CHECK_KIND("1234 12/04 12/05 R6HPEPGLSKNP7R3E9 ONLINE PAYMENT THANK YOU 500.00", LineKind::SkipListed);
+    CHECK_KIND("   12/03 12/14 ONLINE PAYMENT 25.00", LineKind::SkipListed);
+    CHECK_KIND("12/08 12/05 BDLHDGZEHR7EDRB7U LAST STATEMENT BAL FROM ACCT ENDING 1234 83.09", LineKind::SkipListed);
+
+    // One character names and reference numbers
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T X 1.00", LineKind::Transaction);
+    CHECK_KIND("12/05 12/06 Q X 1.00", LineKind::TransactionOld);
+    CHECK_KIND("1234 12/05 12/06 Q 1.00", LineKind::SkippedRelevant); // No name
+
+    // Trailing whitespace and carriage returns
+    for (const std::string ending : {"\r", " \r", "\t", "  ", "\r\n"}) {
+        CHECK_AGREES("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.30" + ending);
+        CHECK_AGREES("12/16 12/23 INTEREST CHARGE ON PURCHASES 12.34" + ending);
+        CHECK_AGREES("12/09 12/16 LFNKABD32R136G0S7 NETFLIX.COM 34.08" + ending);
+        CHECK_AGREES("Minimum Payment $35.00" + ending);
+    }
+    CHECK_AGREES("1234 12/05 12/06 Q75MGCV0RAECBMV6T MC\rDONALDS 92.30");
+    CHECK_AGREES("\r1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.30");
+
+    // Amounts without cents, with thousands separators, and with too many digits after the point
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92", LineKind::Irrelevant);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS $92", LineKind::SkippedRelevant);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.3", LineKind::Irrelevant);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.345", LineKind::SkippedRelevant);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 1,234,567.89", LineKind::Transaction);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS ,5.00", LineKind::Transaction);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 1,2,,3.45", LineKind::Transaction);
+    CHECK_KIND("1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS .99", LineKind::Irrelevant);
+    CHECK_KIND("12/16 12/23 INTEREST CHARGE ON PURCHASES 12", LineKind::Irrelevant);
+
+    // Dates that don't fit "MM/DD"
+    CHECK_KIND("1234 1/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.30", LineKind::SkippedRelevant);
+    CHECK_KIND("12/5 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.30", LineKind::SkippedRelevant);
+    CHECK_KIND("12/055 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92.30", LineKind::SkippedRelevant);
+}
+
+/**
+ * Lines without an amount or a '$' are rejected by the prefilter, so classify() never runs the patterns on them. The
+ * lines are long enough to go through the vector loop of the prefilter, with the interesting part at every position.
+ */
+TEST(prefilterOnlyRejectsIrrelevantLines) {
+    for (const std::string line : {"", " ", "Page 2 of 4", "Transactions", "12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS",
+                                   "1234 12/05 12/06 Q75MGCV0RAECBMV6T MCDONALDS 92", "Total 12.3", ".99", "12. 34"}) {
+        CHECK(!LineClassifier::prefilter(line));
+        CHECK_KIND(line, LineKind::Irrelevant);
+    }
+
+    for (size_t padding = 0; padding < 70; ++padding) {
+        const std::string spaces(padding, ' ');
+        CHECK_AGREES(spaces + "Fees Charged 0.00" + spaces);
+        CHECK_AGREES(spaces + "$" + spaces);
+        CHECK_AGREES(spaces + "1,5.0" + spaces);
+        CHECK_AGREES(std::string(padding, 'x') + "1.23");
+        CHECK_AGREES("1.23" + std::string(padding, 'x'));
+        CHECK(LineClassifier::prefilter(spaces + "$"));
+        CHECK(LineClassifier::prefilter(spaces + "9.99"));
+        CHECK(!LineClassifier::prefilter(spaces + "9.9"));
+    }
+}
@@ -0,0 +1,31 @@
+/**
+ * @file options_test.cpp
+ * @brief Tests for the Options struct.
+ */
+#include <string>
+#include <vector>
+#include "test.h"
+#include "wells_fargo_statement_converter/options.h"
+
+namespace {
+
+/**
+ * @brief Parses the arguments like they were passed on the command line, after the program's name.
+ */
+Options parse(std::vector<std::string> arguments) {
+    arguments.insert(arguments.begin(), "wells_fargo_statement_converter");
+    std::vector<char*> argv;
+    for (auto& argument : arguments) {
+        argv.push_back(argument.data());
+    }
+    return Options::parse(static_cast<int>(argv.size()), argv.data());
+}
+
+} // namespace
+
+TEST(serveRejectsOptionsThatDontApply) {
+    CHECK(parse({"--serve"}).serve);
+    CHECK_THROWS(parse({"--serve", "--dedup"}));
+    CHECK_THROWS(parse({"--serve", "--memory-budget", "64"}));
+    CHECK_THROWS(parse({"--serve", "--watch"}));
+}
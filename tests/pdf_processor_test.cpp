@@ -0,0 +1,312 @@
+/**
+ * @file pdf_processor_test.cpp
+ * @brief Tests for the PdfProcessor class.
+ */
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "test_pdf.h"
+#include "test_transactions.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+#include "wells_fargo_statement_converter/pdf_processor.h"
+
+namespace {
+
+/**
+ * @brief Writes statements named like Wells Fargo names them, one a month starting in January 2024.
+ */
+void writeStatements(const std::string& directory, const size_t count) {
+    std::filesystem::create_directories(directory);
+    for (size_t i = 0; i < count; ++i) {
+        const std::string month = std::to_string(i % 12 + 1);
+        const std::string year = std::to_string(24 + i / 12);
+        const std::string name = std::string(2 - month.size(), '0') + month + "15" + year + constants::regex::PDF_FILE_NAME_SUFFIX;
+        test::writePdf(directory + "/" + name, test::makeStatementPages(std::to_string(1231 + i % 3)));
+    }
+}
+
+/**
+ * @brief The files that a run of the converter wrote.
+ */
+struct Output {
+    std::string csv;
+    std::string skippedLines;
+};
+
+/**
+ * @brief Converts the statements in a directory like main() does, into a new output directory.
+ *
+ * @param configure Changes the settings of the processor before anything is converted.
+ */
+Output runConverter(const std::string& statements, const std::string& output, const std::function<void(PdfProcessor&)>& configure) {
+    std::filesystem::remove_all(output);
+    std::filesystem::create_directories(output);
+    PdfProcessor pdfProcessor(output);
+    configure(pdfProcessor);
+    pdfProcessor.gatherPdfFiles({statements});
+    pdfProcessor.closeSkippedFilesFile();
+    pdfProcessor.processPdfs(statements);
+    pdfProcessor.closeSkippedLinesFile();
+    pdfProcessor.sortTransactions();
+    pdfProcessor.generateCsvFile(constants::CSV_FILE_NAME);
+    pdfProcessor.writeStatistics(constants::STATISTICS_FILE_NAME);
+    return {test::readFile(output + "/" + constants::CSV_FILE_NAME), test::readFile(output + "/" + constants::SKIPPED_LINES_FILE_NAME)};
+}
+
+/**
+ * @brief Converts a statement, and formats its transactions like the CSV file followed by its skipped lines.
+ */
+std::string convert(PdfProcessor& pdfProcessor, const std::vector<char>& pdf) {
+    StatementResult result = pdfProcessor.convertStatement("011524" + constants::regex::PDF_FILE_NAME_SUFFIX, pdf);
+    std::string output;
+    for (const auto& transaction : result.transactions.getTransactions()) {
+        transaction.appendCsvFormat(output);
+    }
+    return output + "--\n" + result.skippedLines;
+}
+
+} // namespace
+
+/**
+ * Directories where the spill files go make every spill fail, like a full disk would. Workers that wait for the front to
+ * move have to be woken up, instead of waiting forever.
+ */
+TEST(spillFailureFailsTheRun) {
+    const test::TemporaryDirectory directory;
+    const std::string output = directory / "output";
+    const size_t statementCount = 20;
+    writeStatements(directory / "statements", statementCount);
+    for (size_t i = 0; i < statementCount; ++i) {
+        std::filesystem::create_directories(output + "/" + constants::SPILL_FILE_PREFIX + std::to_string(i) + ".bin");
+    }
+
+    PdfProcessor pdfProcessor(output);
+    pdfProcessor.setThreadCount(4);
+    pdfProcessor.setMemoryBudget(1);
+    pdfProcessor.gatherPdfFiles({directory / "statements"});
+    pdfProcessor.closeSkippedFilesFile();
+    CHECK_THROWS(pdfProcessor.processPdfs(directory / "statements"));
+    pdfProcessor.closeSkippedLinesFile();
+}
+
+/**
+ * The page with the end of the transaction section has nothing on it that could be saved, so it looks like it can be
+ * pruned. The transaction and the possibly relevant line after it still have to be ignored.
+ */
+TEST(pagePruningKeepsTheSectionEnd) {
+    const test::TemporaryDirectory directory;
+    std::vector<std::vector<std::string>> pages = test::makeStatementPages("1234");
+    pages.push_back({"Totals Year-to-Date", "Interest charged this year"});
+    pages.push_back({"1234 01/10 01/11 8XQ2M1LPZ0E4HK7RT COSTCO WHSE #0001 45.67", "Minimum Payment $35.00"});
+    const std::vector<char> pdf = test::makePdf(pages);
+
+    for (const unsigned int pageThreads : {1u, 3u}) {
+        PdfProcessor pdfProcessor(directory / "output");
+        pdfProcessor.setPageThreadCount(pageThreads);
+        pdfProcessor.setStopAtSectionEnd(true);
+        pdfProcessor.setPagePruning(false);
+        const std::string unpruned = convert(pdfProcessor, pdf);
+        pdfProcessor.setPagePruning(true);
+        const std::string pruned = convert(pdfProcessor, pdf);
+
+        CHECK(pruned == unpruned);
+        CHECK(pruned.find("COSTCO") == std::string::npos);
+        CHECK(pruned.find("Minimum Payment") == std::string::npos);
+        CHECK(pruned.find("NETFLIX.COM") != std::string::npos);
+    }
+}
+
+/**
+ * Last fours that only differ in characters that can't be in a file name, and an account named like the file of
+ * transactions without a last four, each get their own file.
+ */
+TEST(accountFilesDontCollide) {
+    const test::TemporaryDirectory directory;
+    const std::string output = directory / "output";
+    std::filesystem::create_directories(output);
+
+    PdfProcessor pdfProcessor(output);
+    pdfProcessor.setThreadCount(4);
+    pdfProcessor.setAccountFilesEnabled(true);
+    const std::vector<std::string> lastFours = {"12.4", "12,4", "", constants::UNKNOWN_ACCOUNT.substr(0, constants::LAST_FOUR_SIZE), "1234"};
+    for (size_t i = 0; i < lastFours.size(); ++i) {
+        test::addTransaction(pdfProcessor.getTransactions(), lastFours[i], Date(2024, 1, static_cast<int>(i + 1)), "REF" + std::to_string(i), "STORE", 100);
+    }
+    pdfProcessor.generateCsvFile(constants::CSV_FILE_NAME);
+
+    size_t fileCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(output + "/" + constants::ACCOUNT_DIRECTORY)) {
+        const std::string rows = test::readFile(entry.path().string());
+        CHECK(std::count(rows.begin(), rows.end(), '\n') == 1);
+        fileCount++;
+    }
+    CHECK(fileCount == lastFours.size());
+    CHECK(test::readFile(output + "/" + constants::ACCOUNT_DIRECTORY + "/1234.csv").find("\"REF4\"") != std::string::npos);
+    CHECK(test::readFile(output + "/" + constants::ACCOUNT_DIRECTORY + "/" + constants::UNKNOWN_ACCOUNT + ".csv").find("\"REF2\"") != std::string::npos);
+}
+
+TEST(threadsDontChangeTheOutput) {
+    const test::TemporaryDirectory directory;
+    writeStatements(directory / "statements", 14);
+    const Output serial = runConverter(directory / "statements", directory / "output", [](PdfProcessor& pdfProcessor) {
+        pdfProcessor.setThreadCount(1);
+    });
+    CHECK(serial.csv.find("NETFLIX.COM") != std::string::npos);
+    CHECK(serial.skippedLines.find("Total fees $14.09") != std::string::npos);
+
+    for (const unsigned int threads : {1u, 2u, 4u}) {
+        for (const unsigned int pageThreads : {1u, 3u}) {
+            const Output parallel = runConverter(directory / "statements", directory / "output", [&](PdfProcessor& pdfProcessor) {
+                pdfProcessor.setThreadCount(threads);
+                pdfProcessor.setPageThreadCount(pageThreads);
+            });
+            CHECK(parallel.csv == serial.csv);
+            CHECK(parallel.skippedLines == serial.skippedLines);
+        }
+    }
+}
+
+/**
+ * The lines after the end of the transaction section are neither parsed nor counted, with or without page threads.
+ */
+TEST(pageThreadsCountLinesLikeTheSerialPath) {
+    const test::TemporaryDirectory directory;
+    std::vector<std::vector<std::string>> pages = test::makeStatementPages("1234");
+    pages[2].insert(pages[2].begin() + 1, "Totals Year-to-Date $1,000.00");
+    pages.push_back({"Interest charged this year", "1234 01/10 01/11 8XQ2M1LPZ0E4HK7RT COSTCO WHSE #0001 45.67"});
+    pages.push_back({"Page 4 of 4"});
+    const std::vector<char> pdf = test::makePdf(pages);
+
+    for (const bool pruning : {false, true}) {
+        PdfProcessor pdfProcessor(directory / "output");
+        pdfProcessor.setStopAtSectionEnd(true);
+        pdfProcessor.setPagePruning(pruning);
+        pdfProcessor.setPageThreadCount(1);
+        const StatementResult serial = pdfProcessor.convertStatement("011524" + constants::regex::PDF_FILE_NAME_SUFFIX, pdf);
+        pdfProcessor.setPageThreadCount(4);
+        const StatementResult parallel = pdfProcessor.convertStatement("011524" + constants::regex::PDF_FILE_NAME_SUFFIX, pdf);
+
+        CHECK(parallel.statistics.lines == serial.statistics.lines);
+        CHECK(parallel.statistics.matched == serial.statistics.matched);
+        CHECK(parallel.statistics.possiblyRelevant == serial.statistics.possiblyRelevant);
+        CHECK(parallel.skippedLines == serial.skippedLines);
+        CHECK(serial.statistics.lines == pages[0].size() + pages[1].size() + 2);
+    }
+}
+
+/**
+ * Enough rows that the CSV file is formatted on the pool, in several chunks and batches, with a partial chunk at the end.
+ */
+TEST(parallelCsvRowsMatchTheSerialOnes) {
+    const test::TemporaryDirectory directory;
+    const std::string output = directory / "output";
+    std::filesystem::create_directories(output);
+    const size_t rowCount = 5 * 8192 + 123;
+
+    std::string expected;
+    for (const unsigned int threads : {1u, 2u, 4u}) {
+        PdfProcessor pdfProcessor(output);
+        pdfProcessor.setThreadCount(threads);
+        for (size_t i = 0; i < rowCount; ++i) {
+            test::addTransaction(pdfProcessor.getTransactions(), std::to_string(1000 + i % 7), Date(2024, static_cast<int>(i % 12 + 1), 15),
+                                 "REF" + std::to_string(i), "STORE " + std::to_string(i % 97), static_cast<int64_t>(i) * 37 - 50000);
+        }
+        pdfProcessor.generateCsvFile(constants::CSV_FILE_NAME);
+        const std::string csv = test::readFile(output + "/" + constants::CSV_FILE_NAME);
+        CHECK(static_cast<size_t>(std::count(csv.begin(), csv.end(), '\n')) == rowCount);
+        if (threads == 1) {
+            expected = csv;
+        }
+        CHECK(csv == expected);
+    }
+}
+
+/**
+ * A budget of one byte spills every statement, so the CSV and columnar files come from merging the spill files, and the
+ * duplicates have to be dropped while merging.
+ */
+TEST(memoryBudgetDoesntChangeTheOutput) {
+    const test::TemporaryDirectory directory;
+    writeStatements(directory / "statements", 14);
+    const std::string columnarFile = std::filesystem::path(constants::CSV_FILE_NAME).replace_extension(constants::COLUMNAR_FILE_EXTENSION).string();
+
+    std::string withDuplicates;
+    for (const bool deduplication : {false, true}) {
+        const Output unbudgeted = runConverter(directory / "statements", directory / "output", [&](PdfProcessor& pdfProcessor) {
+            pdfProcessor.setDeduplication(deduplication);
+            pdfProcessor.setColumnarEnabled(true);
+        });
+        const std::string unbudgetedColumnar = test::readFile(directory / ("output/" + columnarFile));
+        CHECK(!unbudgetedColumnar.empty());
+        if (!deduplication) {
+            withDuplicates = unbudgeted.csv;
+        }
+        CHECK(deduplication == (unbudgeted.csv.size() < withDuplicates.size()));
+
+        for (const unsigned int threads : {1u, 4u}) {
+            const Output budgeted = runConverter(directory / "statements", directory / "output", [&](PdfProcessor& pdfProcessor) {
+                pdfProcessor.setThreadCount(threads);
+                pdfProcessor.setDeduplication(deduplication);
+                pdfProcessor.setColumnarEnabled(true);
+                pdfProcessor.setMemoryBudget(1);
+            });
+            CHECK(budgeted.csv == unbudgeted.csv);
+            CHECK(budgeted.skippedLines == unbudgeted.skippedLines);
+            CHECK(test::readFile(directory / ("output/" + columnarFile)) == unbudgetedColumnar);
+        }
+    }
+}
+
+/**
+ * The first statement has a transaction and an interest charge twice, which are kept. The second one repeats all of the
+ * first one's transactions, which are dropped, and has another interest charge on the same day, which isn't. The third
+ * one has the same transactions under another account.
+ */
+TEST(dedupDropsTransactionsFromEarlierStatements) {
+    const test::TemporaryDirectory directory;
+    const std::string statements = directory / "statements";
+    std::filesystem::create_directories(statements);
+    std::vector<std::vector<std::string>> repeated = test::makeStatementPages("1234");
+    repeated[1].push_back(repeated[1][2]);
+    repeated[1].push_back(repeated[1][6]);
+    std::vector<std::vector<std::string>> overlapping = test::makeStatementPages("1234");
+    overlapping[1].push_back("12/16 12/23 " + constants::regex::INTEREST_CHARGE + " 12.35");
+    test::writePdf(statements + "/021524" + constants::regex::PDF_FILE_NAME_SUFFIX, repeated);
+    test::writePdf(statements + "/031524" + constants::regex::PDF_FILE_NAME_SUFFIX, overlapping);
+    test::writePdf(statements + "/041524" + constants::regex::PDF_FILE_NAME_SUFFIX, test::makeStatementPages("5678"));
+
+    const Output unbudgeted = runConverter(statements, directory / "output", [](PdfProcessor& pdfProcessor) {
+        pdfProcessor.setDeduplication(true);
+        pdfProcessor.setStatisticsEnabled(true);
+    });
+    CHECK(std::count(unbudgeted.csv.begin(), unbudgeted.csv.end(), '\n') == 6 + 1 + 4);
+    size_t position = 0;
+    size_t mcdonalds = 0;
+    for (position = unbudgeted.csv.find("MCDONALDS"); position != std::string::npos; position = unbudgeted.csv.find("MCDONALDS", position + 1)) {
+        mcdonalds++;
+    }
+    CHECK(mcdonalds == 2 + 1);
+    CHECK(unbudgeted.csv.find("-12.35") != std::string::npos);
+
+    // The totals come first, then each statement in file order
+    std::vector<size_t> duplicates;
+    const std::string statistics = test::readFile(directory / ("output/" + constants::STATISTICS_FILE_NAME));
+    const std::string field = "\"duplicates\": ";
+    for (position = statistics.find(field); position != std::string::npos; position = statistics.find(field, position + 1)) {
+        duplicates.push_back(std::stoul(statistics.substr(position + field.size())));
+    }
+    CHECK(duplicates == std::vector<size_t>({4, 0, 4, 0}));
+
+    for (const unsigned int threads : {1u, 4u}) {
+        const Output budgeted = runConverter(statements, directory / "output", [&](PdfProcessor& pdfProcessor) {
+            pdfProcessor.setThreadCount(threads);
+            pdfProcessor.setDeduplication(true);
+            pdfProcessor.setMemoryBudget(1);
+        });
+        CHECK(budgeted.csv == unbudgeted.csv);
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file run_merge_test.cpp
+ * @brief Tests for the RunMerge and RadixSort classes.
+ */
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "test_transactions.h"
+#include "wells_fargo_statement_converter/radix_sort.h"
+#include "wells_fargo_statement_converter/run_merge.h"
+
+namespace {
+
+/**
+ * @brief Checks that the transactions are sorted by date, and that transactions with the same date kept the order of
+ * their reference numbers, which count up in the order the transactions were added.
+ */
+bool isStablySorted(const std::vector<Transaction>& transactions) {
+    for (size_t i = 1; i < transactions.size(); ++i) {
+        const uint32_t previous = transactions[i - 1].getDate().getKey();
+        const uint32_t current = transactions[i].getDate().getKey();
+        if (previous > current || (previous == current && std::stoul(std::string(transactions[i - 1].getRefNum())) > std::stoul(std::string(transactions[i].getRefNum())))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Adds a transaction whose reference number is its position in the store.
+ */
+void add(TransactionStore& store, const int month, const int day) {
+    test::addTransaction(store, "1234", Date(2024, month, day), std::to_string(store.size()), "STORE", 100);
+}
+
+} // namespace
+
+/**
+ * Every run starts with the date the one before it ends with, and some runs are out of order on their own.
+ */
+TEST(runMergeIsStable) {
+    TransactionStore store;
+    for (int run = 0; run < 6; ++run) {
+        TransactionStore statement;
+        for (int day = 1; day <= 5; ++day) {
+            add(statement, 1, run + day);
+            add(statement, 1, run + day);
+        }
+        if (run % 2 == 1) {
+            add(statement, 1, 1); // Out of order within the run
+        }
+        store.append(std::move(statement));
+    }
+    // append() takes the reference numbers as they were, so number them again in the order they ended up in
+    for (size_t i = 0; i < store.size(); ++i) {
+        store[i].setRefNum(std::to_string(i));
+    }
+    CHECK(store.getRunStarts().size() == 6);
+
+    RunMerge::sort(store.getTransactions(), store.getRunStarts());
+    CHECK(store.size() == 6 * 10 + 3);
+    CHECK(isStablySorted(store.getTransactions()));
+}
+
+TEST(runMergeWithoutRuns) {
+    TransactionStore store;
+    for (int i = 0; i < 50; ++i) {
+        add(store, 12 - i % 12, 1 + i % 3);
+    }
+    RunMerge::sort(store.getTransactions(), {});
+    CHECK(isStablySorted(store.getTransactions()));
+
+    store.clear();
+    for (int i = 0; i < 50; ++i) {
+        add(store, 1 + i % 5, 28 - i % 4);
+    }
+    RunMerge::sort(store.getTransactions(), store.getRunStarts());
+    CHECK(isStablySorted(store.getTransactions()));
+}
+
+/**
+ * Dates far enough apart that every digit of the radix sort moves something.
+ */
+TEST(radixSortIsStable) {
+    TransactionStore store;
+    for (int i = 0; i < 1000; ++i) {
+        test::addTransaction(store, "1234", Date(1990 + (i * 7) % 40, 1 + (i * 5) % 12, 1 + (i * 3) % 28), std::to_string(i), "STORE", i);
+    }
+    RadixSort::sort(store.getTransactions());
+    CHECK(isStablySorted(store.getTransactions()));
+    CHECK(store.size() == 1000);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file statement_cache_test.cpp
+ * @brief Tests for the StatementCache class.
+ */
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "test_pdf.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/pdf_processor.h"
+#include "wells_fargo_statement_converter/statement_cache.h"
+
+TEST(cacheKeyIgnoresTheDirectory) {
+    const test::TemporaryDirectory directory;
+    const StatementCache cache(directory / "cache");
+    const std::vector<char> pdf = test::makePdf(test::makeStatementPages("1234"));
+    const std::string name = "011524" + constants::regex::PDF_FILE_NAME_SUFFIX;
+
+    CHECK(cache.getKey("/home/user/statements/" + name, pdf, "") == cache.getKey("./statements_pdf/" + name, pdf, ""));
+    CHECK(cache.getKey(name, pdf, "") != cache.getKey("021524" + constants::regex::PDF_FILE_NAME_SUFFIX, pdf, ""));
+}
+
+/**
+ * The statement is converted from one directory, then moved to another one, where it has to come from the cache.
+ */
+TEST(movedStatementHitsTheCache) {
+    const test::TemporaryDirectory directory;
+    const std::string name = "011524" + constants::regex::PDF_FILE_NAME_SUFFIX;
+    std::filesystem::create_directories(directory / "before");
+    std::filesystem::create_directories(directory / "after");
+    test::writePdf(directory / ("before/" + name), test::makeStatementPages("1234"));
+
+    PdfProcessor pdfProcessor(directory / "output");
+    pdfProcessor.setCacheEnabled(true);
+    const StatementResult parsed = pdfProcessor.convertFile(directory / ("before/" + name));
+    CHECK(!parsed.statistics.cached);
+    CHECK(parsed.transactions.size() > 0);
+
+    std::filesystem::rename(directory / ("before/" + name), directory / ("after/" + name));
+    const StatementResult cached = pdfProcessor.convertFile(directory / ("after/" + name));
+    CHECK(cached.statistics.cached);
+    CHECK(cached.transactions.size() == parsed.transactions.size());
+    CHECK(cached.skippedLines == parsed.skippedLines);
+}
+
+/**
+ * The same statement in two input directories has one key, and both copies are saved at the same time.
+ */
+TEST(concurrentSavesOfOneKey) {
+    const test::TemporaryDirectory directory;
+    const StatementCache cache(directory / "cache");
+    PdfProcessor pdfProcessor(directory / "output");
+    const std::string name = "011524" + constants::regex::PDF_FILE_NAME_SUFFIX;
+    const std::vector<char> pdf = test::makePdf(test::makeStatementPages("1234"));
+    const StatementResult parsed = pdfProcessor.convertStatement(name, pdf);
+    const uint64_t key = cache.getKey(name, pdf, "");
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 20; ++j) {
+                cache.save(key, parsed);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    StatementResult loaded;
+    CHECK(cache.load(key, loaded));
+    CHECK(loaded.transactions.size() == parsed.transactions.size());
+    CHECK(loaded.skippedLines == parsed.skippedLines);
+    size_t fileCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory / "cache")) {
+        CHECK(entry.path().extension() != ".tmp");
+        fileCount++;
+    }
+    CHECK(fileCount == 1);
+}
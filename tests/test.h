@@ -0,0 +1,105 @@
+/**
+ * @file test.h
+ * @brief A small test framework for the converter's tests.
+ *
+ * Each test is a function declared with TEST(), which registers itself before main() runs. CHECK() and CHECK_THROWS()
+ * report a failure and keep going, so one run shows every failing check.
+ */
+#ifndef TEST_H
+#define TEST_H
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace test {
+
+/**
+ * @struct TestCase
+ * @brief A registered test.
+ */
+struct TestCase {
+    const char* name;
+    std::function<void()> function;
+};
+
+/**
+ * @brief Every test, in the order they were registered.
+ *
+ * @return The tests.
+ */
+std::vector<TestCase>& getTests();
+
+/**
+ * @brief Marks the running test as failed and prints where.
+ *
+ * @param char* The check that failed.
+ * @param char* The file of the check.
+ * @param int The line of the check.
+ */
+void fail(const char*, const char*, const int);
+
+/**
+ * @brief Registers a test when it is constructed.
+ */
+struct Registrar {
+    Registrar(const char* name, std::function<void()> function) {
+        getTests().push_back({name, std::move(function)});
+    }
+};
+
+/**
+ * @class TemporaryDirectory
+ * @brief A new, empty directory in the system's temp directory that is removed with everything in it at the end of the test.
+ */
+class TemporaryDirectory {
+public:
+    TemporaryDirectory();
+    ~TemporaryDirectory();
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    /**
+     * @brief The path of a file or directory inside the directory.
+     *
+     * @param std::string The path relative to the directory.
+     *
+     * @return The path.
+     */
+    std::string operator/(const std::string&) const;
+private:
+    std::filesystem::path path;
+};
+
+} // namespace test
+
+#define TEST(name) \
+    static void name(); \
+    static const test::Registrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            test::fail(#condition, __FILE__, __LINE__); \
+        } \
+    } while (false)
+
+#define CHECK_THROWS(expression) \
+    do { \
+        bool thrown = false; \
+        try { \
+            expression; \
+        } \
+        catch (...) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            test::fail(#expression " throws", __FILE__, __LINE__); \
+        } \
+    } while (false)
+
+#endif
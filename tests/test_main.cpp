@@ -0,0 +1,88 @@
+/**
+ * @file test_main.cpp
+ * @brief Runs every registered test.
+ *
+ * Usage: tests [<name>...]
+ *
+ * With names, only the tests with those names are run. The exit status is the number of failed tests.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "wells_fargo_statement_converter/log_level.h"
+
+LOG_SETUP
+
+namespace {
+
+bool currentFailed = false;
+
+} // namespace
+
+namespace test {
+
+std::vector<TestCase>& getTests() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+void fail(const char* check, const char* file, const int line) {
+    std::fprintf(stderr, "  %s:%d: %s failed\n", file, line, check);
+    currentFailed = true;
+}
+
+/**
+ * Directories are numbered, so tests that run in the same process never share one.
+ */
+TemporaryDirectory::TemporaryDirectory() {
+    static std::atomic<unsigned int> nextNumber(0);
+    path = std::filesystem::temp_directory_path() / ("wells_fargo_test_" + std::to_string(nextNumber++));
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+}
+
+TemporaryDirectory::~TemporaryDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path, error);
+}
+
+std::string TemporaryDirectory::operator/(const std::string& relative) const {
+    return (path / relative).string();
+}
+
+} // namespace test
+
+int main(int argc, char* argv[]) {
+    LOG_VERIFY
+    std::thread logThread = rk::log::startLogThread();
+
+    const std::vector<std::string> names(argv + 1, argv + argc);
+    int failedCount = 0;
+    int runCount = 0;
+    for (const auto& testCase : test::getTests()) {
+        if (!names.empty() && std::find(names.begin(), names.end(), testCase.name) == names.end()) {
+            continue;
+        }
+        std::printf("%s\n", testCase.name);
+        currentFailed = false;
+        try {
+            testCase.function();
+        }
+        catch (const std::exception& e) {
+            std::fprintf(stderr, "  threw: %s\n", e.what());
+            currentFailed = true;
+        }
+        runCount++;
+        failedCount += currentFailed;
+    }
+    std::printf("%d of %d tests passed\n", runCount - failedCount, runCount);
+
+    rk::log::endLogThread(logThread);
+    rk::log::closeLogFile();
+    return failedCount;
+}
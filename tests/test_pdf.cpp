@@ -0,0 +1,112 @@
+/**
+ * @file test_pdf.cpp
+ * @brief Source file for the PDF statements that the tests are run on.
+ */
+#include <fstream>
+#include "test_pdf.h"
+#include "wells_fargo_statement_converter/exception_rk.h"
+
+namespace test {
+
+namespace {
+
+constexpr int PAGE_WIDTH = 612;
+constexpr int PAGE_HEIGHT = 792;
+constexpr int MARGIN = 36;
+constexpr int FONT_SIZE = 9;
+constexpr int LINE_HEIGHT = 12;
+
+/**
+ * @brief Escapes a line for a PDF string literal.
+ */
+std::string escape(const std::string& line) {
+    std::string escaped;
+    for (const char c : line) {
+        if (c == '(' || c == ')' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+/**
+ * Object 1 is the catalog, 2 the page tree and 3 the font. Each page is followed by its content stream, which moves down
+ * a line before every line of text.
+ */
+std::vector<char> makePdf(const std::vector<std::vector<std::string>>& pages) {
+    std::string pdf = "%PDF-1.4\n";
+    std::vector<size_t> offsets;
+    const auto addObject = [&](const std::string& body) {
+        offsets.push_back(pdf.size());
+        pdf += std::to_string(offsets.size()) + " 0 obj\n" + body + "\nendobj\n";
+    };
+
+    std::string kids;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        kids += std::to_string(4 + 2 * i) + " 0 R ";
+    }
+    addObject("<< /Type /Catalog /Pages 2 0 R >>");
+    addObject("<< /Type /Pages /Kids [" + kids + "] /Count " + std::to_string(pages.size()) + " >>");
+    addObject("<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica /Encoding /WinAnsiEncoding >>");
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        addObject("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + std::to_string(PAGE_WIDTH) + " " + std::to_string(PAGE_HEIGHT)
+                  + "] /Resources << /Font << /F1 3 0 R >> >> /Contents " + std::to_string(5 + 2 * i) + " 0 R >>");
+
+        std::string content = "BT\n/F1 " + std::to_string(FONT_SIZE) + " Tf\n" + std::to_string(LINE_HEIGHT) + " TL\n"
+                            + std::to_string(MARGIN) + " " + std::to_string(PAGE_HEIGHT - MARGIN) + " Td\n";
+        for (const auto& line : pages[i]) {
+            content += "T* (" + escape(line) + ") Tj\n";
+        }
+        content += "ET";
+        addObject("<< /Length " + std::to_string(content.size()) + " >>\nstream\n" + content + "\nendstream");
+    }
+
+    const size_t xrefOffset = pdf.size();
+    pdf += "xref\n0 " + std::to_string(offsets.size() + 1) + "\n0000000000 65535 f \n";
+    for (const size_t offset : offsets) {
+        const std::string number = std::to_string(offset);
+        pdf += std::string(10 - number.size(), '0') + number + " 00000 n \n";
+    }
+    pdf += "trailer\n<< /Size " + std::to_string(offsets.size() + 1) + " /Root 1 0 R >>\nstartxref\n" + std::to_string(xrefOffset) + "\n%%EOF\n";
+    return std::vector<char>(pdf.begin(), pdf.end());
+}
+
+void writePdf(const std::string& path, const std::vector<std::vector<std::string>>& pages) {
+    const std::vector<char> pdf = makePdf(pages);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(pdf.data(), static_cast<std::streamsize>(pdf.size()));
+    file.close();
+    if (!file) {
+        throw Exception("Couldn't write " + path);
+    }
+}
+
+std::vector<std::vector<std::string>> makeStatementPages(const std::string& lastFour) {
+    return {
+        {
+            "WELLS FARGO",
+            "Account ending in " + lastFour,
+            "Purchases, Balance Transfers & Other Charges $1,234.56",
+            "Payment due $25.00",
+        },
+        {
+            "Transactions",
+            "Purchases, Balance Transfers & Other Charges",
+            lastFour + " 01/06 01/05 Q75MGCV0RAECBMV6T MCDONALDS RESTAURANT 92.30",
+            lastFour + " 12/15 12/20 LJZLW27A1YXNA4JZX NETFLIX.COM 9,058.81",
+            lastFour + " 12/04 12/05 R6HPEPGLSKNP7R3E9 ONLINE PAYMENT THANK YOU 500.00",
+            "Total fees $14.09",
+            "12/16 12/23 INTEREST CHARGE ON PURCHASES 12.34",
+        },
+        {
+            lastFour + " 01/02 01/03 DKG0R4VFNRP1AZMK6 TRADER JOE S #123 SAN JOSE CA 34.08",
+            "Page 3 of 4",
+        },
+    };
+}
+
+} // namespace test
@@ -0,0 +1,43 @@
+/**
+ * @file test_pdf.h
+ * @brief Header file for the PDF statements that the tests are run on.
+ */
+#ifndef TEST_PDF_H
+#define TEST_PDF_H
+
+#include <string>
+#include <vector>
+
+namespace test {
+
+/**
+ * @brief Makes a PDF file with a line of text per row, which Poppler extracts line by line like a real statement.
+ *
+ * The text is in Helvetica, so only ASCII can be used.
+ *
+ * @param std::vector<std::vector<std::string>> The lines of each page.
+ *
+ * @return The bytes of the PDF file.
+ */
+std::vector<char> makePdf(const std::vector<std::vector<std::string>>&);
+
+/**
+ * @brief Writes a PDF file made by makePdf().
+ *
+ * @param std::string The path of the file.
+ * @param std::vector<std::vector<std::string>> The lines of each page.
+ */
+void writePdf(const std::string&, const std::vector<std::vector<std::string>>&);
+
+/**
+ * @brief The pages of a small statement, with a few transactions, skipped lines and possibly relevant lines.
+ *
+ * @param std::string The last four of the account.
+ *
+ * @return The lines of each page.
+ */
+std::vector<std::vector<std::string>> makeStatementPages(const std::string&);
+
+} // namespace test
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file test_transactions.cpp
+ * @brief Source file for the transactions that the tests are run on.
+ */
+#include <fstream>
+#include <iterator>
+#include "test_transactions.h"
+
+namespace test {
+
+Transaction& addTransaction(TransactionStore& store, const std::string_view lastFour, const Date& date, const std::string_view refNum, const std::string_view name, const int64_t amount) {
+    Transaction& transaction = store.add();
+    transaction.setLastFour(lastFour);
+    transaction.setDate(date);
+    transaction.setRefNum(refNum);
+    transaction.setName(store.storeName(name));
+    transaction.setAmount(amount);
+    return transaction;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+} // namespace test
@@ -0,0 +1,41 @@
+/**
+ * @file test_transactions.h
+ * @brief Header file for the transactions that the tests are run on.
+ */
+#ifndef TEST_TRANSACTIONS_H
+#define TEST_TRANSACTIONS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "wells_fargo_statement_converter/date.h"
+#include "wells_fargo_statement_converter/transaction_store.h"
+
+namespace test {
+
+/**
+ * @brief Adds a transaction to the current run of a store. Its name is copied into the store.
+ *
+ * @param TransactionStore The store.
+ * @param std::string_view The last four.
+ * @param Date The date.
+ * @param std::string_view The reference number.
+ * @param std::string_view The name.
+ * @param int64_t The amount, in cents.
+ *
+ * @return The transaction.
+ */
+Transaction& addTransaction(TransactionStore&, const std::string_view, const Date&, const std::string_view, const std::string_view, const int64_t);
+
+/**
+ * @brief Reads a whole file.
+ *
+ * @param std::string The path of the file.
+ *
+ * @return The contents of the file. Empty if it doesn't exist.
+ */
+std::string readFile(const std::string&);
+
+} // namespace test
+
+#endif
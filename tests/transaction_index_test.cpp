@@ -0,0 +1,46 @@
+/**
+ * @file transaction_index_test.cpp
+ * @brief Tests for the TransactionIndex class.
+ */
+#include <string>
+#include "test.h"
+#include "test_transactions.h"
+#include "wells_fargo_statement_converter/constants.h"
+#include "wells_fargo_statement_converter/transaction_index.h"
+#include "wells_fargo_statement_converter/transaction_store.h"
+
+TEST(transactionIndexKeys) {
+    TransactionStore store;
+    const Date date(2024, 1, 15);
+    test::addTransaction(store, "1234", date, "Q75MGCV0RAECBMV6T", "MCDONALDS", 9230);
+    test::addTransaction(store, "1234", date, "Q75MGCV0RAECBMV6T", "MCDONALDS RESTAURANT", 9230); // Only the name differs
+    test::addTransaction(store, "5678", date, "Q75MGCV0RAECBMV6T", "MCDONALDS", 9230);
+    test::addTransaction(store, "1234", date, "", constants::regex::INTEREST_CHARGE, 1234);
+    test::addTransaction(store, "1234", date, "", constants::regex::INTEREST_CHARGE, 1235);
+    test::addTransaction(store, "1234", date, "", "INTEREST CHARGE ON CASH ADVANCES", 1234);
+    test::addTransaction(store, "1234", date, "", constants::regex::INTEREST_CHARGE, 1234);
+
+    // Without a reference number, the name is part of the key
+    CHECK(TransactionIndex::isSame(store[0], store[1]));
+    CHECK(!TransactionIndex::isSame(store[0], store[2]));
+    CHECK(!TransactionIndex::isSame(store[3], store[4]));
+    CHECK(!TransactionIndex::isSame(store[3], store[5]));
+    CHECK(TransactionIndex::isSame(store[3], store[6]));
+
+    TransactionIndex index;
+    CHECK(index.find(store.getTransactions(), store[0]) == TransactionIndex::NOT_FOUND);
+    size_t added = 0;
+    for (size_t i = 0; i < store.size(); ++i) {
+        added += index.insert(store.getTransactions(), store[i], i);
+    }
+    CHECK(added == 5);
+    CHECK(index.size() == 5);
+    CHECK(index.find(store.getTransactions(), store[1]) == 0);
+    CHECK(index.find(store.getTransactions(), store[6]) == 3);
+    CHECK(index.find(store.getTransactions(), store[5]) == 5);
+
+    index.reset();
+    CHECK(index.size() == 0);
+    CHECK(index.find(store.getTransactions(), store[0]) == TransactionIndex::NOT_FOUND);
+    CHECK(index.insert(store.getTransactions(), store[6], 6));
+}
@@ -0,0 +1,106 @@
+/**
+ * @file transaction_test.cpp
+ * @brief Tests for the formatting and parsing of the Transaction class.
+ */
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "test.h"
+#include "wells_fargo_statement_converter/transaction.h"
+
+namespace {
+
+/**
+ * @brief Formats an amount with Transaction::appendAmount().
+ */
+std::string formatAmount(const int64_t amount) {
+    std::string formatted;
+    Transaction::appendAmount(formatted, amount);
+    return formatted;
+}
+
+/**
+ * @brief Checks that an amount comes back from its CSV format. A charge is written with a '-' and a refund without one.
+ */
+bool roundTrips(const int64_t amount) {
+    const std::string formatted = formatAmount(amount);
+    const bool charge = !formatted.empty() && formatted[0] == '-';
+    int64_t parsed = 0;
+    if (!Transaction::parseAmount(charge ? formatted.substr(1) : formatted, parsed)) {
+        return false;
+    }
+    return charge ? parsed == amount : parsed == -amount;
+}
+
+/**
+ * @brief Parses an amount, or returns -1 if it isn't valid.
+ */
+int64_t parse(const std::string& text) {
+    int64_t cents = 0;
+    return Transaction::parseAmount(text, cents) ? cents : -1;
+}
+
+} // namespace
+
+TEST(amountsAreFormattedAsCharges) {
+    CHECK(formatAmount(1534) == "-15.34");
+    CHECK(formatAmount(0) == "-0.00");
+    CHECK(formatAmount(5) == "-0.05");
+    CHECK(formatAmount(99) == "-0.99");
+    CHECK(formatAmount(100) == "-1.00");
+    CHECK(formatAmount(200000) == "-2000.00");
+    CHECK(formatAmount(-1534) == "15.34");
+    CHECK(formatAmount(-7) == "0.07");
+    CHECK(formatAmount(std::numeric_limits<int64_t>::max()) == "-92233720368547758.07");
+    CHECK(formatAmount(std::numeric_limits<int64_t>::min()) == "92233720368547758.08");
+}
+
+TEST(amountsAreParsed) {
+    CHECK(parse("0.00") == 0);
+    CHECK(parse("0.05") == 5);
+    CHECK(parse("0.99") == 99);
+    CHECK(parse("25.00") == 2500);
+    CHECK(parse("1,234.56") == 123456);
+    CHECK(parse("9,058.81") == 905881);
+    CHECK(parse("1,000,000.00") == 100000000);
+    CHECK(parse("92233720368547758.07") == std::numeric_limits<int64_t>::max());
+    CHECK(parse("92,233,720,368,547,758.07") == std::numeric_limits<int64_t>::max());
+
+    CHECK(parse("92233720368547758.08") == -1);
+    CHECK(parse("100000000000000000.00") == -1);
+    CHECK(parse("25") == -1);
+    CHECK(parse("25.0") == -1);
+    CHECK(parse("25.000") == -1);
+    CHECK(parse(".50") == -1);
+    CHECK(parse("-1.00") == -1);
+    CHECK(parse("1a.00") == -1);
+    CHECK(parse("1.0a") == -1);
+    CHECK(parse("1.,0") == -1);
+    CHECK(parse("") == -1);
+}
+
+TEST(amountsRoundTrip) {
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    for (const int64_t amount : {int64_t{0}, int64_t{1}, int64_t{10}, int64_t{99}, int64_t{100}, int64_t{1534}, int64_t{123456}, int64_t{100000000}, max, max - 1, max - 99}) {
+        CHECK(roundTrips(amount));
+        CHECK(roundTrips(-amount));
+    }
+    for (int64_t amount = -250; amount <= 250; ++amount) {
+        CHECK(roundTrips(amount));
+    }
+    // Its magnitude doesn't fit into an int64_t as a positive amount
+    CHECK(!roundTrips(std::numeric_limits<int64_t>::min()));
+}
+
+TEST(csvRowsArePadded) {
+    const Transaction transaction(905881, "NETFLIX.COM", Date(2024, 1, 5), "LJZLW27A1YXNA4JZX", "1234");
+    CHECK(transaction.getCsvFormat() == "\"1234\",\"01/05/2024\",\"LJZLW27A1YXNA4JZX\",\"NETFLIX.COM\",\"-9058.81\"");
+
+    const Transaction interest(-50, "INTEREST CHARGE ON PURCHASES", Date(999, 12, 31), "", "");
+    CHECK(interest.getCsvFormat() == "\"\",\"12/31/0999\",\"\",\"INTEREST CHARGE ON PURCHASES\",\"0.50\"");
+
+    std::string csv;
+    Transaction(100, "A", Date(7, 10, 1), "R", "12").appendCsvFormat(csv);
+    Transaction(1, "B", Date(2023, 9, 30), "S", "34").appendCsvFormat(csv);
+    CHECK(csv == "\"12\",\"10/01/0007\",\"R\",\"A\",\"-1.00\"\"34\",\"09/30/2023\",\"S\",\"B\",\"-0.01\"");
+}